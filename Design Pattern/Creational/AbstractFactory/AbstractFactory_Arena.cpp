@@ -0,0 +1,320 @@
+/*
+Arena-backed Abstract Factory.
+
+This is the furniture family from AbstractFactory_1.cpp, but the factory owns a memory region (an arena) and the products are
+placement-constructed into it instead of being handed out one `new` at a time. Products created by an arena factory belong to the
+factory: the client never deletes them, and the whole batch is released in one shot with releaseAll(). This removes almost all of
+the heap traffic when a program creates millions of short-lived products.
+
+The arena is a monotonic buffer: allocation only bumps a pointer inside the current chunk, and release() simply rewinds to the first
+chunk while keeping the memory for the next batch. Because nothing is destroyed one by one, products must be trivially destructible.
+
+Build: g++ -std=c++17 -O2 AbstractFactory_Arena.cpp
+
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
+using namespace std;
+
+// Abstract product classes
+class Chair {
+public:
+    virtual void sit() = 0;
+};
+
+class Sofa {
+public:
+    virtual void lieDown() = 0;
+};
+
+// Concrete product classes
+class VictorianChair final : public Chair {
+public:
+    void sit() {
+        cout << "Sitting on a Victorian chair" << endl;
+    }
+};
+
+class VictorianSofa final : public Sofa {
+public:
+    void lieDown() {
+        cout << "Lying down on a Victorian sofa" << endl;
+    }
+};
+
+class ModernChair final : public Chair {
+public:
+    void sit() {
+        cout << "Sitting on a modern chair" << endl;
+    }
+};
+
+class ModernSofa final : public Sofa {
+public:
+    void lieDown() {
+        cout << "Lying down on a modern sofa" << endl;
+    }
+};
+
+// Abstract factory class
+class FurnitureFactory {
+public:
+    virtual ~FurnitureFactory() {}
+    virtual Chair* createChair() = 0;
+    virtual Sofa* createSofa() = 0;
+};
+
+// Concrete factory classes (per-object new/delete)
+class VictorianFurnitureFactory : public FurnitureFactory {
+public:
+    VictorianChair* createChair() {
+        return new VictorianChair();
+    }
+    VictorianSofa* createSofa() {
+        return new VictorianSofa();
+    }
+};
+
+class ModernFurnitureFactory : public FurnitureFactory {
+public:
+    ModernChair* createChair() {
+        return new ModernChair();
+    }
+    ModernSofa* createSofa() {
+        return new ModernSofa();
+    }
+};
+
+// Monotonic memory region: bump allocation inside fixed-size chunks, released all at once
+class FurnitureArena {
+public:
+    explicit FurnitureArena(size_t chunkSize = 64 * 1024)
+        : m_chunkSize(chunkSize) {}
+
+    FurnitureArena(const FurnitureArena&) = delete;
+    FurnitureArena& operator=(const FurnitureArena&) = delete;
+
+    template <typename T>
+    T* make() {
+        static_assert(is_trivially_destructible<T>::value,
+                      "arena products are released without running destructors");
+        return new (allocate(sizeof(T), alignof(T))) T();
+    }
+
+    // Constructs n objects of T back to back and returns the first one
+    template <typename T>
+    T* makeArray(size_t n) {
+        static_assert(is_trivially_destructible<T>::value,
+                      "arena products are released without running destructors");
+        T* first = static_cast<T*>(allocate(sizeof(T) * n, alignof(T)));
+        for (size_t i = 0; i < n; ++i) {
+            new (first + i) T();
+        }
+        return first;
+    }
+
+    // Rewinds to the first chunk; the memory is kept for the next batch
+    void release() {
+        m_current = 0;
+        m_offset = 0;
+    }
+
+    size_t reservedBytes() const {
+        size_t total = 0;
+        for (auto& chunk : m_chunks) {
+            total += chunk.size;
+        }
+        return total;
+    }
+
+private:
+    struct Chunk {
+        unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void* allocate(size_t bytes, size_t alignment) {
+        while (m_current < m_chunks.size()) {
+            Chunk& chunk = m_chunks[m_current];
+            size_t aligned = (m_offset + alignment - 1) & ~(alignment - 1);
+            if (aligned + bytes <= chunk.size) {
+                m_offset = aligned + bytes;
+                return chunk.data.get() + aligned;
+            }
+            ++m_current;
+            m_offset = 0;
+        }
+
+        // operator new[] storage is aligned for any fundamental type, so offset 0 is always aligned
+        size_t size = bytes > m_chunkSize ? bytes : m_chunkSize;
+        m_chunks.push_back(Chunk{ unique_ptr<char[]>(new char[size]), size });
+        m_current = m_chunks.size() - 1;
+        m_offset = bytes;
+        return m_chunks.back().data.get();
+    }
+
+    size_t m_chunkSize;
+    vector<Chunk> m_chunks;
+    size_t m_current = 0;
+    size_t m_offset = 0;
+};
+
+// Abstract arena factory: products belong to the factory and must not be deleted by the client
+class ArenaFurnitureFactory : public FurnitureFactory {
+public:
+    explicit ArenaFurnitureFactory(size_t chunkSize = 64 * 1024)
+        : m_arena(chunkSize) {}
+
+    // Batch API: n products constructed contiguously in the arena
+    virtual vector<Chair*> createChairs(size_t n) = 0;
+    virtual vector<Sofa*> createSofas(size_t n) = 0;
+
+    // Releases every product created so far in one shot
+    void releaseAll() {
+        m_arena.release();
+    }
+
+    size_t reservedBytes() const {
+        return m_arena.reservedBytes();
+    }
+
+protected:
+    template <typename Concrete, typename Product>
+    vector<Product*> createBatch(size_t n) {
+        Concrete* first = m_arena.makeArray<Concrete>(n);
+        vector<Product*> products(n);
+        for (size_t i = 0; i < n; ++i) {
+            products[i] = first + i;
+        }
+        return products;
+    }
+
+    FurnitureArena m_arena;
+};
+
+// Concrete arena factory classes
+class VictorianArenaFurnitureFactory : public ArenaFurnitureFactory {
+public:
+    using ArenaFurnitureFactory::ArenaFurnitureFactory;
+
+    Chair* createChair() {
+        return m_arena.make<VictorianChair>();
+    }
+    Sofa* createSofa() {
+        return m_arena.make<VictorianSofa>();
+    }
+    vector<Chair*> createChairs(size_t n) {
+        return createBatch<VictorianChair, Chair>(n);
+    }
+    vector<Sofa*> createSofas(size_t n) {
+        return createBatch<VictorianSofa, Sofa>(n);
+    }
+};
+
+class ModernArenaFurnitureFactory : public ArenaFurnitureFactory {
+public:
+    using ArenaFurnitureFactory::ArenaFurnitureFactory;
+
+    Chair* createChair() {
+        return m_arena.make<ModernChair>();
+    }
+    Sofa* createSofa() {
+        return m_arena.make<ModernSofa>();
+    }
+    vector<Chair*> createChairs(size_t n) {
+        return createBatch<ModernChair, Chair>(n);
+    }
+    vector<Sofa*> createSofas(size_t n) {
+        return createBatch<ModernSofa, Sofa>(n);
+    }
+};
+
+// Resident set size in kilobytes (Linux only, 0 elsewhere)
+long residentKb() {
+    ifstream status("/proc/self/status");
+    string key;
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            long kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+void benchmark(size_t count) {
+    using Clock = chrono::steady_clock;
+
+    // Arena path first: its chunks stay reserved until the factory goes away, so the
+    // heap path below cannot reuse them and both RSS deltas start from fresh memory
+    VictorianArenaFurnitureFactory arenaFactory;
+    vector<Chair*> chairs(count);
+    long rssBefore = residentKb();
+    auto start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        chairs[i] = arenaFactory.createChair();
+    }
+    long arenaRss = residentKb() - rssBefore;
+    arenaFactory.releaseAll();
+    chrono::duration<double> arenaTime = Clock::now() - start;
+
+    // Arena path, batch API (reuses the memory released above)
+    start = Clock::now();
+    vector<Chair*> batch = arenaFactory.createChairs(count);
+    arenaFactory.releaseAll();
+    chrono::duration<double> batchTime = Clock::now() - start;
+
+    // Per-object new/delete path
+    VictorianFurnitureFactory heapFactory;
+    vector<VictorianChair*> heapChairs(count);
+    rssBefore = residentKb();
+    start = Clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        heapChairs[i] = heapFactory.createChair();
+    }
+    long heapRss = residentKb() - rssBefore;
+    for (VictorianChair* chair : heapChairs) {
+        delete chair;
+    }
+    chrono::duration<double> heapTime = Clock::now() - start;
+
+    cout << "\n" << count << " chairs created and released" << endl;
+    cout << "  new/delete     : " << count / heapTime.count() / 1e6 << " M allocs/s, RSS +" << heapRss << " KB" << endl;
+    cout << "  arena          : " << count / arenaTime.count() / 1e6 << " M allocs/s, RSS +" << arenaRss << " KB" << endl;
+    cout << "  arena (batch)  : " << count / batchTime.count() / 1e6 << " M allocs/s, "
+         << arenaFactory.reservedBytes() / 1024 << " KB reserved" << endl;
+}
+
+int main() {
+    // Create a Victorian arena factory; products live until releaseAll()
+    VictorianArenaFurnitureFactory victorianFactory;
+    Chair* victorianChair = victorianFactory.createChair();
+    Sofa* victorianSofa = victorianFactory.createSofa();
+
+    victorianChair->sit();
+    victorianSofa->lieDown();
+
+    // Create a whole batch of modern chairs at once
+    ModernArenaFurnitureFactory modernFactory;
+    vector<Chair*> modernChairs = modernFactory.createChairs(3);
+    for (Chair* chair : modernChairs) {
+        chair->sit();
+    }
+
+    // Release every product of each factory in one shot (no per-object delete)
+    victorianFactory.releaseAll();
+    modernFactory.releaseAll();
+
+    benchmark(10000000);
+
+    return 0;
+}
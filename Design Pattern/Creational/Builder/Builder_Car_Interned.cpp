@@ -0,0 +1,268 @@
+/*
+
+A compact Car for the builder samples.
+
+The Car in Builder_Car_With_Director.cpp and Builder_Car_Without_Director.cpp keeps make, model and color as three std::strings
+(about 100 bytes per car before any heap allocation) and getDescription() concatenates five temporaries on every call. A fleet has
+only a handful of distinct makes, models and colors, so CompactCar stores each of them as a small integer ID into a shared symbol
+table and fits in 8 bytes. getDescription() returns a std::string_view into a description cache: every distinct (make, model,
+year, color) combination is formatted once, the first time it is asked for, and reused by every car that shares it.
+
+The symbol table and the description cache are process-wide and not synchronized: build and describe cars from one thread, or
+guard them with a mutex. Strings handed out by them stay valid for the lifetime of the program.
+
+Build: g++ -std=c++17 -O2 Builder_Car_Interned.cpp
+
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Current layout, as in the other builder samples
+class Car {
+public:
+    void setMake(const std::string& make) {
+        m_make = make;
+    }
+
+    void setModel(const std::string& model) {
+        m_model = model;
+    }
+
+    void setYear(int year) {
+        m_year = year;
+    }
+
+    void setColor(const std::string& color) {
+        m_color = color;
+    }
+
+    std::string getDescription() const {
+        return "This is a " + std::to_string(m_year) + " " + m_make + " " + m_model + " in " + m_color + ".";
+    }
+
+private:
+    std::string m_make;
+    std::string m_model;
+    int m_year = 0;
+    std::string m_color;
+};
+
+// Shared table of interned strings; each distinct string gets a small integer ID
+class SymbolTable {
+public:
+    using Id = std::uint16_t;
+
+    // Id of the empty string, reserved up front so default-constructed cars need no lookup
+    static constexpr Id EMPTY = 0;
+
+    static SymbolTable& instance() {
+        static SymbolTable table;
+        return table;
+    }
+
+    Id intern(std::string_view text) {
+        auto found = m_ids.find(text);
+        if (found != m_ids.end()) {
+            return found->second;
+        }
+        if (m_symbols.size() > UINT16_MAX) {
+            throw std::length_error("Symbol table is full");
+        }
+        // std::deque never moves its elements, so the views used as keys stay valid
+        const std::string& stored = m_symbols.emplace_back(text);
+        Id id = static_cast<Id>(m_symbols.size() - 1);
+        m_ids.emplace(stored, id);
+        return id;
+    }
+
+    std::string_view lookup(Id id) const {
+        return m_symbols[id];
+    }
+
+private:
+    SymbolTable() {
+        intern("");
+    }
+
+    std::deque<std::string> m_symbols;
+    std::unordered_map<std::string_view, Id> m_ids;
+};
+
+class CompactCar {
+public:
+    void setMake(std::string_view make) {
+        m_make = SymbolTable::instance().intern(make);
+    }
+
+    void setModel(std::string_view model) {
+        m_model = SymbolTable::instance().intern(model);
+    }
+
+    void setYear(int year) {
+        m_year = static_cast<std::uint16_t>(year);
+    }
+
+    void setColor(std::string_view color) {
+        m_color = SymbolTable::instance().intern(color);
+    }
+
+    std::string_view getMake() const { return SymbolTable::instance().lookup(m_make); }
+    std::string_view getModel() const { return SymbolTable::instance().lookup(m_model); }
+    int getYear() const { return m_year; }
+    std::string_view getColor() const { return SymbolTable::instance().lookup(m_color); }
+
+    // Formatted once per distinct configuration, then served from the cache
+    std::string_view getDescription() const {
+        static std::unordered_map<std::uint64_t, std::string> cache;
+        auto found = cache.find(key());
+        if (found != cache.end()) {
+            return found->second;
+        }
+        std::string description = "This is a " + std::to_string(m_year) + " ";
+        description.append(getMake()).append(" ").append(getModel()).append(" in ").append(getColor()).append(".");
+        return cache.emplace(key(), std::move(description)).first->second;
+    }
+
+private:
+    std::uint64_t key() const {
+        return (std::uint64_t(m_make) << 48) | (std::uint64_t(m_model) << 32) | (std::uint64_t(m_year) << 16) | m_color;
+    }
+
+    SymbolTable::Id m_make{ SymbolTable::EMPTY };
+    SymbolTable::Id m_model{ SymbolTable::EMPTY };
+    std::uint16_t m_year = 0;
+    SymbolTable::Id m_color{ SymbolTable::EMPTY };
+};
+
+class CompactCarBuilder {
+public:
+    CompactCarBuilder& setMake(std::string_view make) {
+        car.setMake(make);
+        return *this;
+    }
+
+    CompactCarBuilder& setModel(std::string_view model) {
+        car.setModel(model);
+        return *this;
+    }
+
+    CompactCarBuilder& setYear(int year) {
+        car.setYear(year);
+        return *this;
+    }
+
+    CompactCarBuilder& setColor(std::string_view color) {
+        car.setColor(color);
+        return *this;
+    }
+
+    CompactCar build() {
+        return car;
+    }
+
+private:
+    CompactCar car;
+};
+
+// Resident set size in kilobytes (Linux only, 0 elsewhere)
+long residentKb() {
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            long kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+void benchmark(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    const char* makes[] = { "Ford", "Chevrolet", "Dodge", "Pontiac" };
+    const char* models[] = { "Mustang", "Camaro", "Challenger", "Firebird Trans Am" };
+    const char* colors[] = { "red", "blue", "black", "metallic silver-grey" };
+
+    std::cout << "\n" << count << " cars\n";
+
+    // Compact layout first, so its memory cannot come from pages freed by the std::string layout
+    long before = residentKb();
+    std::vector<CompactCar> cars(count);
+    CompactCarBuilder builder;
+    for (size_t i = 0; i < count; ++i) {
+        cars[i] = builder.setMake(makes[i % 4])
+                         .setModel(models[(i / 4) % 4])
+                         .setYear(1965 + static_cast<int>(i % 10))
+                         .setColor(colors[(i / 16) % 4])
+                         .build();
+    }
+    long used = residentKb() - before;
+
+    auto start = Clock::now();
+    size_t chars = 0;
+    for (const CompactCar& car : cars) {
+        chars += car.getDescription().size();
+    }
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::cout << "  CompactCar      : " << sizeof(CompactCar) << " bytes inline, "
+              << used * 1024.0 / count << " bytes/car resident, "
+              << count / elapsed.count() / 1e6 << " M descriptions/s (" << chars << " chars)\n";
+
+    {
+        long before = residentKb();
+        std::vector<Car> cars(count);
+        for (size_t i = 0; i < count; ++i) {
+            cars[i].setMake(makes[i % 4]);
+            cars[i].setModel(models[(i / 4) % 4]);
+            cars[i].setYear(1965 + static_cast<int>(i % 10));
+            cars[i].setColor(colors[(i / 16) % 4]);
+        }
+        long used = residentKb() - before;
+
+        auto start = Clock::now();
+        size_t chars = 0;
+        for (const Car& car : cars) {
+            chars += car.getDescription().size();
+        }
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        std::cout << "  std::string Car : " << sizeof(Car) << " bytes inline, "
+                  << used * 1024.0 / count << " bytes/car resident, "
+                  << count / elapsed.count() / 1e6 << " M descriptions/s (" << chars << " chars)\n";
+    }
+}
+
+int main() {
+   CompactCarBuilder builder;
+
+   // Build a red Ford Mustang from 1967
+   CompactCar mustang = builder.setMake("Ford")
+                               .setModel("Mustang")
+                               .setYear(1967)
+                               .setColor("red")
+                               .build();
+
+   // Build a blue Chevrolet Camaro from 1970
+   CompactCar camaro = builder.setMake("Chevrolet")
+                              .setModel("Camaro")
+                              .setYear(1970)
+                              .setColor("blue")
+                              .build();
+
+   // Print the descriptions of the cars
+   std::cout << mustang.getDescription() << "\n";
+   std::cout << camaro.getDescription() << "\n";
+
+   benchmark(10000000);
+
+   return 0;
+}
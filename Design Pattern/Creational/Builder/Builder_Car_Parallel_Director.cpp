@@ -0,0 +1,280 @@
+/*
+
+The Director sample from Builder_Car_With_Director.cpp, extended for building large fleets.
+
+1. Move-out build path: CarBuilder::getCar() returns a copy of the builder's car, so every built car copies all of its strings.
+   releaseCar() moves the car out instead and resets the builder, so the same builder can start on the next car right away.
+
+2. Parallel batch construction: Director::constructBatch(n, threads) splits the fleet into one contiguous range per thread.
+   Each thread gets its own builder (created with CarBuilder::newBuilder()) and moves its cars straight into their final slot
+   of the result vector, so there is no shared state while building and no copy when the per-thread results are merged.
+
+Build: g++ -std=c++17 -O2 -pthread Builder_Car_Parallel_Director.cpp
+
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Car {
+public:
+    void setMake(const std::string& make) {
+        m_make = make;
+    }
+
+    void setModel(const std::string& model) {
+        m_model = model;
+    }
+
+    void setYear(int year) {
+        m_year = year;
+    }
+
+    void setColor(const std::string& color) {
+        m_color = color;
+    }
+
+    std::string getDescription() const {
+        return "This is a " + std::to_string(m_year) + " " + m_make + " " + m_model + " in " + m_color + ".";
+    }
+
+private:
+    std::string m_make;
+    std::string m_model;
+    int m_year = 0;
+    std::string m_color;
+};
+
+class CarBuilder {
+public:
+   virtual ~CarBuilder() {}
+
+   virtual void buildMake() {}
+   virtual void buildModel() {}
+   virtual void buildYear() {}
+   virtual void buildColor() {}
+
+   // A new builder of the same kind, so every thread can build with its own instance
+   virtual std::unique_ptr<CarBuilder> newBuilder() const = 0;
+
+   Car getCar() {
+       return car;
+   }
+
+   // Moves the finished car out and leaves the builder ready for the next one
+   Car releaseCar() {
+       Car built = std::move(car);
+       car = Car();
+       return built;
+   }
+
+protected:
+   Car car;
+};
+
+class MustangBuilder : public CarBuilder {
+public:
+   void buildMake() override {
+       car.setMake("Ford");
+   }
+
+   void buildModel() override {
+       car.setModel("Mustang");
+   }
+
+   void buildYear() override {
+       car.setYear(1967);
+   }
+
+   void buildColor() override {
+       car.setColor("red");
+   }
+
+   std::unique_ptr<CarBuilder> newBuilder() const override {
+       return std::make_unique<MustangBuilder>();
+   }
+};
+
+class CamaroBuilder : public CarBuilder {
+public:
+   void buildMake() override {
+       car.setMake("Chevrolet");
+   }
+
+   void buildModel() override {
+       car.setModel("Camaro");
+   }
+
+   void buildYear() override {
+       car.setYear(1970);
+  }
+
+  void buildColor() override {
+      car.setColor("blue");
+  }
+
+   std::unique_ptr<CarBuilder> newBuilder() const override {
+       return std::make_unique<CamaroBuilder>();
+   }
+};
+
+class Director {
+public:
+  Director(CarBuilder* builder)
+      : builder(builder) {}
+
+  Car constructCar()
+  {
+      buildSteps(*builder);
+      return builder->getCar();
+  }
+
+  // Same steps, but the car is moved out of the builder instead of copied
+  Car constructCarMoved()
+  {
+      buildSteps(*builder);
+      return builder->releaseCar();
+  }
+
+  // Builds n cars on up to `threads` threads. Each thread owns a builder and a contiguous
+  // slice of the result, so cars are moved into place once and never copied or re-merged.
+  std::vector<Car> constructBatch(size_t n, unsigned threads)
+  {
+      std::vector<Car> fleet(n);
+      threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(n, 1))));
+
+      auto buildRange = [this, &fleet](size_t begin, size_t end) {
+          std::unique_ptr<CarBuilder> local = builder->newBuilder();
+          for (size_t i = begin; i < end; ++i) {
+              buildSteps(*local);
+              fleet[i] = local->releaseCar();
+          }
+      };
+
+      // Exceptions thrown on a worker are kept here and rethrown on the calling thread
+      std::vector<std::exception_ptr> errors(threads);
+      std::vector<std::thread> workers;
+      JoinGuard joiner{ workers };
+
+      size_t chunk = n / threads;
+      size_t extra = n % threads;
+      size_t begin = 0;
+      for (unsigned t = 0; t < threads; ++t) {
+          size_t end = begin + chunk + (t < extra ? 1 : 0);
+          if (t + 1 == threads) {
+              buildRange(begin, end); // the calling thread takes the last slice
+          }
+          else {
+              workers.emplace_back([&buildRange, &errors, t, begin, end] {
+                  try {
+                      buildRange(begin, end);
+                  }
+                  catch (...) {
+                      errors[t] = std::current_exception();
+                  }
+              });
+          }
+          begin = end;
+      }
+      joiner.joinAll();
+      for (auto& error : errors) {
+          if (error) {
+              std::rethrow_exception(error);
+          }
+      }
+      return fleet;
+  }
+
+private:
+  // Joins every worker on the way out, including when the calling thread's slice throws
+  struct JoinGuard
+  {
+      std::vector<std::thread>& workers;
+
+      void joinAll()
+      {
+          for (auto& worker : workers) {
+              if (worker.joinable()) {
+                  worker.join();
+              }
+          }
+      }
+
+      ~JoinGuard() { joinAll(); }
+  };
+
+  static void buildSteps(CarBuilder& target)
+  {
+      target.buildMake();
+      target.buildModel();
+      target.buildYear();
+      target.buildColor();
+  }
+
+  CarBuilder* builder;
+};
+
+void benchmark(size_t count)
+{
+  using Clock = std::chrono::steady_clock;
+  MustangBuilder mustang_builder;
+  Director director(&mustang_builder);
+
+  auto start = Clock::now();
+  std::vector<Car> copied;
+  copied.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+      copied.push_back(director.constructCar());
+  }
+  std::chrono::duration<double> copyTime = Clock::now() - start;
+
+  start = Clock::now();
+  std::vector<Car> moved;
+  moved.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+      moved.push_back(director.constructCarMoved());
+  }
+  std::chrono::duration<double> moveTime = Clock::now() - start;
+
+  std::cout << "\n" << count << " cars" << "\n";
+  std::cout << "  getCar (copy)     : " << count / copyTime.count() / 1e6 << " M cars/s\n";
+  std::cout << "  releaseCar (move) : " << count / moveTime.count() / 1e6 << " M cars/s\n";
+
+  unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned threads = 1; threads <= cores; threads *= 2) {
+      start = Clock::now();
+      std::vector<Car> fleet = director.constructBatch(count, threads);
+      std::chrono::duration<double> batchTime = Clock::now() - start;
+      std::cout << "  constructBatch x" << threads << " : " << count / batchTime.count() / 1e6 << " M cars/s\n";
+  }
+}
+
+int main()
+{
+  MustangBuilder mustang_builder;
+  CamaroBuilder camaro_builder;
+
+  Director director1(&mustang_builder);
+  Director director2(&camaro_builder);
+
+  // Build a Mustang without copying it out of the builder
+  Car mustang = director1.constructCarMoved();
+
+  // Build a small fleet of Camaros on two threads
+  std::vector<Car> camaros = director2.constructBatch(3, 2);
+
+  std::cout << mustang.getDescription() << "\n";
+  for (const Car& camaro : camaros) {
+      std::cout << camaro.getDescription() << "\n";
+  }
+
+  benchmark(2000000);
+
+ return EXIT_SUCCESS;
+}
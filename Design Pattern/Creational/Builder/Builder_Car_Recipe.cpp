@@ -0,0 +1,269 @@
+/*
+
+Compile-time recipes for the Director of Builder_Car_With_Director.cpp.
+
+MustangBuilder and CamaroBuilder run four virtual build* calls and construct four strings at runtime, although the car they
+produce is fully known at compile time. Here a fixed configuration is described by a constexpr CarSpec, and
+Director::construct<Spec>() turns it into a PresetCar without any virtual call or string construction: the fields are
+std::string_views into the spec and the description is formatted by the compiler into a static character array.
+
+The dynamic path is unchanged: cars configured at runtime still go through a CarBuilder and come out as a regular Car, and a
+PresetCar can be turned into one with toCar() when an owning, mutable copy is needed.
+
+Build: g++ -std=c++17 -O2 Builder_Car_Recipe.cpp
+
+*/
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Car {
+public:
+    void setMake(const std::string& make) {
+        m_make = make;
+    }
+
+    void setModel(const std::string& model) {
+        m_model = model;
+    }
+
+    void setYear(int year) {
+        m_year = year;
+    }
+
+    void setColor(const std::string& color) {
+        m_color = color;
+    }
+
+    std::string getDescription() const {
+        return "This is a " + std::to_string(m_year) + " " + m_make + " " + m_model + " in " + m_color + ".";
+    }
+
+private:
+    std::string m_make;
+    std::string m_model;
+    int m_year = 0;
+    std::string m_color;
+};
+
+// ---------------------------------------------------------------------------
+// Dynamic path (runtime-configured cars)
+// ---------------------------------------------------------------------------
+
+class CarBuilder {
+public:
+   virtual ~CarBuilder() {}
+
+   virtual void buildMake() {}
+   virtual void buildModel() {}
+   virtual void buildYear() {}
+   virtual void buildColor() {}
+
+   Car getCar() {
+       return car;
+   }
+
+protected:
+   Car car;
+};
+
+class MustangBuilder : public CarBuilder {
+public:
+   void buildMake() override {
+       car.setMake("Ford");
+   }
+
+   void buildModel() override {
+       car.setModel("Mustang");
+   }
+
+   void buildYear() override {
+       car.setYear(1967);
+   }
+
+   void buildColor() override {
+       car.setColor("red");
+   }
+};
+
+// ---------------------------------------------------------------------------
+// Compile-time path (fixed configurations)
+// ---------------------------------------------------------------------------
+
+struct CarSpec {
+    std::string_view make;
+    std::string_view model;
+    int year;
+    std::string_view color;
+};
+
+// Known configurations
+constexpr CarSpec Mustang1967{ "Ford", "Mustang", 1967, "red" };
+constexpr CarSpec Camaro1970{ "Chevrolet", "Camaro", 1970, "blue" };
+
+// Formats "This is a <year> <make> <model> in <color>." at compile time
+template <const CarSpec& Spec>
+class CarRecipe {
+    static constexpr std::size_t digits(int value) {
+        std::size_t count = 1;
+        while (value >= 10) {
+            value /= 10;
+            ++count;
+        }
+        return count;
+    }
+
+    static constexpr std::string_view prefix = "This is a ";
+    static constexpr std::size_t length = prefix.size() + digits(Spec.year) + 1 + Spec.make.size() + 1
+                                        + Spec.model.size() + 4 + Spec.color.size() + 1;
+
+    static constexpr std::array<char, length> format() {
+        std::array<char, length> out{};
+        std::size_t pos = 0;
+        auto append = [&out, &pos](std::string_view text) {
+            for (char c : text) {
+                out[pos++] = c;
+            }
+        };
+        append(prefix);
+        for (std::size_t i = digits(Spec.year), year = Spec.year; i > 0; --i, year /= 10) {
+            out[pos + i - 1] = static_cast<char>('0' + year % 10);
+        }
+        pos += digits(Spec.year);
+        append(" ");
+        append(Spec.make);
+        append(" ");
+        append(Spec.model);
+        append(" in ");
+        append(Spec.color);
+        append(".");
+        return out;
+    }
+
+    static constexpr std::array<char, length> text = format();
+
+public:
+    static constexpr std::string_view description{ text.data(), text.size() };
+};
+
+// Car produced from a recipe: a view of static data, built without virtual calls or allocations
+class PresetCar {
+public:
+    constexpr PresetCar(const CarSpec& spec, std::string_view description)
+        : m_spec(&spec), m_description(description) {}
+
+    constexpr std::string_view getMake() const { return m_spec->make; }
+    constexpr std::string_view getModel() const { return m_spec->model; }
+    constexpr int getYear() const { return m_spec->year; }
+    constexpr std::string_view getColor() const { return m_spec->color; }
+
+    constexpr std::string_view getDescription() const {
+        return m_description;
+    }
+
+    // Owning copy for code that needs a regular, mutable Car
+    Car toCar() const {
+        Car car;
+        car.setMake(std::string(getMake()));
+        car.setModel(std::string(getModel()));
+        car.setYear(getYear());
+        car.setColor(std::string(getColor()));
+        return car;
+    }
+
+private:
+    const CarSpec* m_spec;
+    std::string_view m_description;
+};
+
+class Director {
+public:
+  Director(CarBuilder* builder)
+      : builder(builder) {}
+
+  // Runtime-configured cars
+  Car constructCar()
+  {
+      builder->buildMake();
+      builder->buildModel();
+      builder->buildYear();
+      builder->buildColor();
+
+      return builder->getCar();
+  }
+
+  // Fixed configurations, resolved entirely at compile time
+  template <const CarSpec& Spec>
+  static constexpr PresetCar construct()
+  {
+      return PresetCar(Spec, CarRecipe<Spec>::description);
+  }
+
+private:
+  CarBuilder* builder;
+};
+
+static_assert(Director::construct<Camaro1970>().getDescription() == "This is a 1970 Chevrolet Camaro in blue.",
+              "recipe descriptions are formatted at compile time");
+
+void benchmark(size_t count)
+{
+  using Clock = std::chrono::steady_clock;
+  MustangBuilder mustang_builder;
+  Director director(&mustang_builder);
+
+  auto start = Clock::now();
+  std::vector<Car> dynamicCars;
+  dynamicCars.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+      dynamicCars.push_back(director.constructCar());
+  }
+  size_t chars = 0;
+  for (const Car& car : dynamicCars) {
+      chars += car.getDescription().size();
+  }
+  std::chrono::duration<double> dynamicTime = Clock::now() - start;
+
+  start = Clock::now();
+  std::vector<PresetCar> presetCars;
+  presetCars.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+      presetCars.push_back(Director::construct<Mustang1967>());
+  }
+  size_t presetChars = 0;
+  for (const PresetCar& car : presetCars) {
+      presetChars += car.getDescription().size();
+  }
+  std::chrono::duration<double> presetTime = Clock::now() - start;
+
+  std::cout << "\n" << count << " cars built and described" << "\n";
+  std::cout << "  CarBuilder (virtual, runtime strings) : " << dynamicTime.count() * 1e9 / count << " ns/car ("
+            << chars << " chars)\n";
+  std::cout << "  CarRecipe (compile time)              : " << presetTime.count() * 1e9 / count << " ns/car ("
+            << presetChars << " chars)\n";
+}
+
+int main()
+{
+  MustangBuilder mustang_builder;
+  Director director(&mustang_builder);
+
+  // Runtime path: a builder configures the car step by step
+  Car mustang = director.constructCar();
+
+  // Compile-time path: the whole car, description included, is a constant
+  constexpr PresetCar camaro = Director::construct<Camaro1970>();
+
+  // Print the descriptions of the cars
+  std::cout << mustang.getDescription() << "\n";
+  std::cout << camaro.getDescription() << "\n";
+
+  benchmark(10000000);
+
+ return EXIT_SUCCESS;
+}
@@ -0,0 +1,287 @@
+
+/*
+Streaming bulk mode for the Email builder of Builder_1.cpp.
+
+Building every Email through EmailBuilder::from/to/subject/body copies each field into an owning std::string, which is slow when
+the emails come from very large exports. EmailBulkBuilder memory-maps the export and walks it once, producing EmailView objects
+whose fields are std::string_views into the mapping. Nothing is copied unless the caller asks for ownership with materialize(),
+which goes through the regular EmailBuilder. Views are only valid while the EmailBulkBuilder that produced them is alive.
+
+Input format: one email per line, "from,to,subject,body". The body is the rest of the line, so it may contain commas.
+Memory mapping uses POSIX mmap (Linux / macOS).
+
+Build: g++ -std=c++17 -O2 Builder_Email_Bulk.cpp
+*/
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Forward declaring the builder
+class EmailBuilder;
+
+class Email
+{
+  public:
+    friend class EmailBuilder;  // the builder can access Email's privates
+
+    static EmailBuilder make();
+
+    const string& from() const { return m_from; }
+    const string& to() const { return m_to; }
+    const string& subject() const { return m_subject; }
+    const string& body() const { return m_body; }
+
+  private:
+    Email() = default; // restrict construction to builder
+
+    string m_from;
+    string m_to;
+    string m_subject;
+    string m_body;
+};
+
+class EmailBuilder
+{
+  public:
+    EmailBuilder& from(const string &from) {
+        m_email.m_from = from;
+        return *this;
+    }
+
+    EmailBuilder& to(const string &to) {
+        m_email.m_to = to;
+        return *this;
+    }
+
+    EmailBuilder& subject(const string &subject) {
+        m_email.m_subject = subject;
+        return *this;
+    }
+
+    EmailBuilder& body(const string &body) {
+        m_email.m_body = body;
+        return *this;
+    }
+
+    operator Email&&() {
+        return std::move(m_email); // notice the move
+    }
+
+  private:
+    Email m_email;
+};
+
+EmailBuilder Email::make()
+{
+    return EmailBuilder();
+}
+
+// Non-owning email: every field points into the mapped input
+struct EmailView
+{
+    string_view from;
+    string_view to;
+    string_view subject;
+    string_view body;
+
+    // Copies the fields into an owning Email
+    Email materialize() const {
+        return Email::make().from(string(from))
+                            .to(string(to))
+                            .subject(string(subject))
+                            .body(string(body));
+    }
+};
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+  public:
+    explicit MappedFile(const string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw runtime_error("Cannot stat " + path);
+        }
+        m_size = static_cast<size_t>(info.st_size);
+        if (m_size > 0) {
+            void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                ::close(fd);
+                throw runtime_error("Cannot map " + path);
+            }
+            ::madvise(data, m_size, MADV_SEQUENTIAL); // we read it once, front to back
+            m_data = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+
+    ~MappedFile() {
+        if (m_data) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    string_view contents() const { return string_view(m_data, m_size); }
+
+  private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+class EmailBulkBuilder
+{
+  public:
+    explicit EmailBulkBuilder(const string& path)
+        : m_file(path) {}
+
+    // Single streaming pass over the file; calls visit(const EmailView&) for every well-formed line
+    // and returns the number of emails produced. Lines with fewer than four fields are skipped.
+    template <typename Visitor>
+    size_t forEach(Visitor&& visit) const {
+        string_view rest = m_file.contents();
+        size_t count = 0;
+        while (!rest.empty()) {
+            size_t end = rest.find('\n');
+            string_view line = rest.substr(0, end);
+            rest.remove_prefix(end == string_view::npos ? rest.size() : end + 1);
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+
+            EmailView email;
+            if (nextField(line, email.from) && nextField(line, email.to) && nextField(line, email.subject)) {
+                email.body = line;
+                visit(static_cast<const EmailView&>(email));
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    vector<EmailView> build() const {
+        vector<EmailView> emails;
+        forEach([&](const EmailView& email) { emails.push_back(email); });
+        return emails;
+    }
+
+    size_t sizeBytes() const { return m_file.contents().size(); }
+
+  private:
+    static bool nextField(string_view& line, string_view& field) {
+        size_t comma = line.find(',');
+        if (comma == string_view::npos) {
+            return false;
+        }
+        field = line.substr(0, comma);
+        line.remove_prefix(comma + 1);
+        return true;
+    }
+
+    MappedFile m_file;
+};
+
+// Current path: read line by line and copy every field through EmailBuilder
+vector<Email> buildByCopy(const string& path)
+{
+    vector<Email> emails;
+    ifstream input(path);
+    string line;
+    while (getline(input, line)) {
+        size_t a = line.find(',');
+        size_t b = a == string::npos ? a : line.find(',', a + 1);
+        size_t c = b == string::npos ? b : line.find(',', b + 1);
+        if (c == string::npos) {
+            continue;
+        }
+        emails.push_back(Email::make().from(line.substr(0, a))
+                                      .to(line.substr(a + 1, b - a - 1))
+                                      .subject(line.substr(b + 1, c - b - 1))
+                                      .body(line.substr(c + 1)));
+    }
+    return emails;
+}
+
+void benchmark(size_t count)
+{
+    const string path = "emails_benchmark.csv";
+    {
+        ofstream output(path);
+        for (size_t i = 0; i < count; ++i) {
+            output << "sender" << i << "@mail.com,receiver" << i % 1000 << "@mail.com,"
+                   << "Report #" << i << ",Numbers for week " << i % 52 << ", all systems nominal.\n";
+        }
+    }
+
+    using Clock = chrono::steady_clock;
+    auto report = [](const char* label, size_t emails, size_t bytes, chrono::duration<double> elapsed) {
+        cout << "  " << label << bytes / elapsed.count() / (1024 * 1024) << " MB/s, "
+             << emails / elapsed.count() / 1e6 << " M emails/s" << endl;
+    };
+
+    auto start = Clock::now();
+    vector<Email> copied = buildByCopy(path);
+    chrono::duration<double> copyTime = Clock::now() - start;
+
+    start = Clock::now();
+    EmailBulkBuilder bulk(path);
+    vector<EmailView> views = bulk.build();
+    chrono::duration<double> viewTime = Clock::now() - start;
+
+    start = Clock::now();
+    size_t bodyBytes = 0;
+    size_t streamed = EmailBulkBuilder(path).forEach([&](const EmailView& email) { bodyBytes += email.body.size(); });
+    chrono::duration<double> streamTime = Clock::now() - start;
+
+    cout << "\n" << count << " emails, " << bulk.sizeBytes() / (1024 * 1024) << " MB" << endl;
+    report("copying builder   : ", copied.size(), bulk.sizeBytes(), copyTime);
+    report("bulk views        : ", views.size(), bulk.sizeBytes(), viewTime);
+    report("bulk forEach      : ", streamed, bulk.sizeBytes(), streamTime);
+
+    remove(path.c_str());
+}
+
+int main()
+{
+    const string path = "emails_sample.csv";
+    {
+        ofstream output(path);
+        output << "me@mail.com,you@mail.com,C++ builders,I like this API, don't you?\n"
+               << "you@mail.com,me@mail.com,Re: C++ builders,Yes, especially the bulk mode.\n";
+    }
+
+    {
+        EmailBulkBuilder builder(path);
+        vector<EmailView> emails = builder.build();
+        for (const EmailView& email : emails) {
+            cout << "from: " << email.from << "\nsubject: " << email.subject << "\nbody: " << email.body << endl;
+        }
+
+        // take ownership of one email so it outlives the mapping
+        Email kept = emails.front().materialize();
+        cout << "materialized: " << kept.subject() << endl;
+    }
+    remove(path.c_str());
+
+    benchmark(2000000);
+}
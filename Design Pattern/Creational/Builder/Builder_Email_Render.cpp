@@ -0,0 +1,201 @@
+
+/*
+The Email builder from Builder_1.cpp with an allocation-free rendering path.
+
+Builder_1.cpp renders an Email through a stringstream and returns a fresh std::string on every call. Here the rendering is split in
+two steps: rendered_size() computes the exact length up front, and render_to() / append_to() copy the fields straight into a
+caller-supplied buffer or a reusable std::string. No stream object is created and a message costs at most one allocation (none
+when the caller reuses its buffer). to_string() and operator<< are built on top of the same path.
+
+Build: g++ -std=c++17 -O2 Builder_Email_Render.cpp
+*/
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Forward declaring the builder
+class EmailBuilder;
+
+class Email
+{
+  public:
+    friend class EmailBuilder;  // the builder can access Email's privates
+
+    static EmailBuilder make();
+
+    // Exact number of characters render_to() writes
+    size_t rendered_size() const {
+        return (sizeof(FROM) - 1) + m_from.size()
+             + (sizeof(TO) - 1) + m_to.size()
+             + (sizeof(SUBJECT) - 1) + m_subject.size()
+             + (sizeof(BODY) - 1) + m_body.size();
+    }
+
+    // Writes the message into buffer and returns the number of characters written.
+    // Nothing is written (and 0 is returned) when capacity is smaller than rendered_size().
+    size_t render_to(char* buffer, size_t capacity) const {
+        size_t size = rendered_size();
+        if (capacity < size) {
+            return 0;
+        }
+        char* out = buffer;
+        out = put(out, FROM, sizeof(FROM) - 1);
+        out = put(out, m_from.data(), m_from.size());
+        out = put(out, TO, sizeof(TO) - 1);
+        out = put(out, m_to.data(), m_to.size());
+        out = put(out, SUBJECT, sizeof(SUBJECT) - 1);
+        out = put(out, m_subject.data(), m_subject.size());
+        out = put(out, BODY, sizeof(BODY) - 1);
+        put(out, m_body.data(), m_body.size());
+        return size;
+    }
+
+    // Appends the message to out, growing it at most once
+    void append_to(string& out) const {
+        size_t old_size = out.size();
+        out.resize(old_size + rendered_size());
+        render_to(&out[old_size], out.size() - old_size);
+    }
+
+    string to_string() const {
+        string result;
+        append_to(result);
+        return result;
+    }
+
+    // Previous implementation, kept for the benchmark
+    string to_string_stream() const {
+        stringstream stream;
+        stream << "from: " << m_from
+               << "\nto: " << m_to
+               << "\nsubject: " << m_subject
+               << "\nbody: " << m_body;
+        return stream.str();
+    }
+
+    friend ostream& operator <<(ostream& stream, const Email& email);
+
+  private:
+    Email() = default; // restrict construction to builder
+
+    static constexpr char FROM[] = "from: ";
+    static constexpr char TO[] = "\nto: ";
+    static constexpr char SUBJECT[] = "\nsubject: ";
+    static constexpr char BODY[] = "\nbody: ";
+
+    static char* put(char* out, const char* data, size_t size) {
+        memcpy(out, data, size);
+        return out + size;
+    }
+
+    string m_from;
+    string m_to;
+    string m_subject;
+    string m_body;
+};
+
+class EmailBuilder
+{
+  public:
+    EmailBuilder& from(const string &from) {
+        m_email.m_from = from;
+        return *this;
+    }
+
+    EmailBuilder& to(const string &to) {
+        m_email.m_to = to;
+        return *this;
+    }
+
+    EmailBuilder& subject(const string &subject) {
+        m_email.m_subject = subject;
+        return *this;
+    }
+
+    EmailBuilder& body(const string &body) {
+        m_email.m_body = body;
+        return *this;
+    }
+
+    operator Email&&() {
+        return std::move(m_email); // notice the move
+    }
+
+  private:
+    Email m_email;
+};
+
+EmailBuilder Email::make()
+{
+    return EmailBuilder();
+}
+
+// Writes the fields straight into the stream, no temporary string
+std::ostream& operator <<(std::ostream& stream, const Email& email)
+{
+    stream.write(Email::FROM, sizeof(Email::FROM) - 1).write(email.m_from.data(), email.m_from.size());
+    stream.write(Email::TO, sizeof(Email::TO) - 1).write(email.m_to.data(), email.m_to.size());
+    stream.write(Email::SUBJECT, sizeof(Email::SUBJECT) - 1).write(email.m_subject.data(), email.m_subject.size());
+    stream.write(Email::BODY, sizeof(Email::BODY) - 1).write(email.m_body.data(), email.m_body.size());
+    return stream;
+}
+
+template <typename Render>
+void measure(const char* label, size_t count, Render render)
+{
+    auto start = chrono::steady_clock::now();
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i) {
+        bytes += render();
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "  " << label << count / elapsed.count() / 1e6 << " M messages/s (" << bytes << " bytes)" << endl;
+}
+
+void benchmark(size_t count)
+{
+    Email mail = Email::make().from("newsletter@mail.com")
+                              .to("subscriber@mail.com")
+                              .subject("Weekly digest")
+                              .body("Here is what happened in the C++ world this week.");
+
+    cout << "\nRendering " << count << " messages" << endl;
+    measure("stringstream          : ", count, [&] { return mail.to_string_stream().size(); });
+    measure("to_string             : ", count, [&] { return mail.to_string().size(); });
+
+    string reused;
+    measure("append_to (reused)    : ", count, [&] {
+        reused.clear();
+        mail.append_to(reused);
+        return reused.size();
+    });
+
+    vector<char> buffer(mail.rendered_size());
+    measure("render_to (buffer)    : ", count, [&] { return mail.render_to(buffer.data(), buffer.size()); });
+}
+
+int main()
+{
+
+    // there is no director to create the object
+
+    Email mail = Email::make().from("me@mail.com")
+                              .to("you@mail.com")
+                              .subject("C++ builders")
+                              .body("I like this API, don't you?");
+
+    cout << mail << endl;
+
+    // render into a caller-supplied buffer
+    char buffer[256];
+    size_t size = mail.render_to(buffer, sizeof(buffer));
+    cout << string(buffer, size) << endl;
+
+    benchmark(5000000);
+}
@@ -0,0 +1,266 @@
+/*
+Parallel bring-up for devices created by the DeviceFactory of Factory_Managing_Diverse_Device.cpp.
+
+Device::connect() is synchronous, so connecting thousands of factory-created devices one after the other takes as long as the sum
+of all their connection latencies. Here every device also has connectAsync(), and a BringUpScheduler connects a whole list of
+devices with a bounded pool of worker threads:
+
+- at most `workers` connections are in flight at any time;
+- each device type can have its own, lower limit (e.g. only a few Bluetooth pairings at once), so a worker skips devices whose
+  type is at its limit and picks the next one;
+- every connection is timed and the report keeps the per-device result.
+
+SimulatedDevice stands in for real hardware: it just sleeps for a configurable latency, so the speedup can be measured locally.
+
+Build: g++ -std=c++17 -O2 -pthread Factory_Device_Bringup.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Device {
+public:
+    virtual ~Device() {}
+    virtual void connect() = 0;
+    virtual std::string type() const = 0;
+
+    // Runs connect() on its own thread; bring-up of many devices should go through BringUpScheduler instead
+    std::future<void> connectAsync() {
+        return std::async(std::launch::async, [this] { connect(); });
+    }
+};
+
+class Sensor : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting sensor via I2C protocol..." << std::endl;
+    }
+    std::string type() const override { return "sensor"; }
+};
+
+class Printer : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting printer via Bluetooth..." << std::endl;
+    }
+    std::string type() const override { return "printer"; }
+};
+
+// Stand-in for real hardware: connecting takes `latency` and prints nothing
+class SimulatedDevice : public Device {
+public:
+    SimulatedDevice(std::string type, std::chrono::milliseconds latency)
+        : m_type(std::move(type)), m_latency(latency) {}
+
+    void connect() override {
+        std::this_thread::sleep_for(m_latency);
+    }
+    std::string type() const override { return m_type; }
+
+private:
+    std::string m_type;
+    std::chrono::milliseconds m_latency;
+};
+
+class DeviceFactory {
+public:
+    static std::unique_ptr<Device> createDevice(const std::string& type) {
+        if ( type == "sensor" ) {
+            return std::make_unique<Sensor>();
+        }
+        else if ( type == "printer" ) {
+            return std::make_unique<Printer>();
+        }
+        else {
+            throw std::invalid_argument("Unknown device type: " + type);
+        }
+    }
+};
+
+struct BringUpResult {
+    Device* device;
+    std::chrono::duration<double, std::milli> elapsed;
+    bool connected;
+    std::string error;
+};
+
+class BringUpScheduler {
+public:
+    explicit BringUpScheduler(unsigned workers)
+        : m_workers(std::max(1u, workers)) {}
+
+    // Limits how many devices of one type may be connecting at the same time
+    void setTypeLimit(const std::string& type, unsigned limit) {
+        m_typeLimits[type] = std::max(1u, limit);
+    }
+
+    // Connects every device and returns one result per device, in input order
+    std::vector<BringUpResult> connectAll(const std::vector<Device*>& devices) {
+        std::vector<BringUpResult> results(devices.size());
+
+        // Devices waiting to connect, queued per type in input order
+        std::map<std::string, std::deque<size_t>> pending;
+        for (size_t i = 0; i < devices.size(); ++i) {
+            pending[devices[i]->type()].push_back(i);
+        }
+
+        std::mutex mutex;
+        std::condition_variable slotFreed;
+        std::map<std::string, unsigned> inFlight;
+        size_t remaining = devices.size();
+
+        // Takes the next device whose type has a free slot; returns false when none is ready
+        auto takeReady = [&](size_t& index, const std::string*& type) {
+            for (auto& queue : pending) {
+                if (queue.second.empty()) {
+                    continue;
+                }
+                auto limit = m_typeLimits.find(queue.first);
+                if (limit == m_typeLimits.end() || inFlight[queue.first] < limit->second) {
+                    index = queue.second.front();
+                    queue.second.pop_front();
+                    type = &queue.first;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto work = [&] {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (remaining > 0) {
+                size_t index;
+                const std::string* type;
+                if (!takeReady(index, type)) {
+                    slotFreed.wait(lock);
+                    continue;
+                }
+                --remaining;
+                ++inFlight[*type];
+                lock.unlock();
+
+                BringUpResult& result = results[index];
+                result.device = devices[index];
+                auto start = std::chrono::steady_clock::now();
+                try {
+                    devices[index]->connect();
+                    result.connected = true;
+                }
+                catch (const std::exception& e) {
+                    result.connected = false;
+                    result.error = e.what();
+                }
+                catch (...) {
+                    result.connected = false;
+                    result.error = "unknown exception";
+                }
+                result.elapsed = std::chrono::steady_clock::now() - start;
+
+                lock.lock();
+                --inFlight[*type];
+                slotFreed.notify_all();
+            }
+        };
+
+        std::vector<std::thread> pool;
+        JoinGuard joiner{ pool }; // if a thread cannot be started, the ones already running finish the list first
+        unsigned count = static_cast<unsigned>(std::min<size_t>(m_workers, devices.size()));
+        for (unsigned t = 0; t < count; ++t) {
+            pool.emplace_back(work);
+        }
+        joiner.joinAll();
+        return results;
+    }
+
+    // Runs connectAll() in the background
+    std::future<std::vector<BringUpResult>> connectAllAsync(std::vector<Device*> devices) {
+        return std::async(std::launch::async, [this, devices] { return connectAll(devices); });
+    }
+
+private:
+    // Joins every worker on the way out, including when starting one of them throws
+    struct JoinGuard {
+        std::vector<std::thread>& workers;
+
+        void joinAll() {
+            for (auto& worker : workers) {
+                if (worker.joinable()) {
+                    worker.join();
+                }
+            }
+        }
+
+        ~JoinGuard() { joinAll(); }
+    };
+
+    unsigned m_workers;
+    std::map<std::string, unsigned> m_typeLimits;
+};
+
+void benchmark(size_t count) {
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::unique_ptr<Device>> owned;
+    std::vector<Device*> devices;
+    for (size_t i = 0; i < count; ++i) {
+        bool sensor = i % 4 != 0;
+        owned.push_back(std::make_unique<SimulatedDevice>(sensor ? "sensor" : "printer",
+                                                          std::chrono::milliseconds(sensor ? 2 : 8)));
+        devices.push_back(owned.back().get());
+    }
+
+    auto start = Clock::now();
+    for (Device* device : devices) {
+        device->connect();
+    }
+    std::chrono::duration<double> serialTime = Clock::now() - start;
+
+    BringUpScheduler scheduler(64);
+    scheduler.setTypeLimit("printer", 8);
+    start = Clock::now();
+    std::vector<BringUpResult> results = scheduler.connectAll(devices);
+    std::chrono::duration<double> parallelTime = Clock::now() - start;
+
+    double slowest = 0;
+    for (const BringUpResult& result : results) {
+        slowest = std::max(slowest, result.elapsed.count());
+    }
+
+    std::cout << "\n" << count << " simulated devices (sensor 2 ms, printer 8 ms, at most 8 printers at once)" << std::endl;
+    std::cout << "  serial connect()        : " << serialTime.count() << " s" << std::endl;
+    std::cout << "  scheduler, 64 workers   : " << parallelTime.count() << " s, "
+              << serialTime.count() / parallelTime.count() << "x faster, slowest device " << slowest << " ms" << std::endl;
+}
+
+int main() {
+    // Use factory to create devices
+    auto sensor = DeviceFactory::createDevice("sensor");
+    auto printer = DeviceFactory::createDevice("printer");
+
+    // Connect one device in the background
+    std::future<void> pending = sensor->connectAsync();
+    pending.wait();
+
+    // Bring up a list of devices through the scheduler and report the timing per device
+    BringUpScheduler scheduler(4);
+    scheduler.setTypeLimit("printer", 1);
+    std::vector<BringUpResult> results = scheduler.connectAllAsync({ sensor.get(), printer.get() }).get();
+    for (const BringUpResult& result : results) {
+        std::cout << result.device->type() << ": " << (result.connected ? "connected" : result.error)
+                  << " in " << result.elapsed.count() << " ms" << std::endl;
+    }
+
+    benchmark(1000);
+
+    return 0;
+}
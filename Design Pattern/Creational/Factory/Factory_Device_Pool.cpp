@@ -0,0 +1,229 @@
+/*
+Object pool mode for the DeviceFactory of Factory_Managing_Diverse_Device.cpp.
+
+Endpoints connect and drop all the time, so the plain factory spends its time in make_unique and delete for Sensor / Printer
+handles that look exactly like the ones it just destroyed. In pool mode the factory hands out DeviceHandles whose deleter gives
+the object back to a per-type pool instead of freeing it, and the next request for that type reuses it.
+
+Each pool keeps a small free list per thread (no locking on the fast path) and a shared overflow list behind a mutex: a thread
+whose local list is full moves half of it to the overflow, and a thread whose local list is empty refills from the overflow
+before falling back to new. A recycled device gets a reset() call so no state leaks from one endpoint to the next.
+
+Build: g++ -std=c++17 -O2 -pthread Factory_Device_Pool.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+class Device {
+public:
+    virtual ~Device() {}
+    virtual void connect() = 0;
+
+    // Called when a pooled device is recycled, before it is handed out again
+    virtual void reset() {}
+};
+
+class Sensor : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting sensor via I2C protocol..." << std::endl;
+    }
+};
+
+class Printer : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting printer via Bluetooth..." << std::endl;
+    }
+};
+
+class DevicePool {
+public:
+    virtual ~DevicePool() {}
+    virtual void recycle(Device* device) = 0;
+};
+
+// Gives the device back to its pool, or deletes it when it was not pooled
+struct DeviceDeleter {
+    DevicePool* pool = nullptr;
+
+    void operator()(Device* device) const {
+        if (pool) {
+            pool->recycle(device);
+        }
+        else {
+            delete device;
+        }
+    }
+};
+
+using DeviceHandle = std::unique_ptr<Device, DeviceDeleter>;
+
+template <typename T>
+class TypedDevicePool : public DevicePool {
+public:
+    static constexpr size_t LOCAL_CAPACITY = 64;
+
+    static TypedDevicePool& instance() {
+        static TypedDevicePool pool;
+        return pool;
+    }
+
+    ~TypedDevicePool() {
+        for (T* device : m_shared) {
+            delete device;
+        }
+    }
+
+    DeviceHandle acquire() {
+        std::vector<T*>& local = localCache().items;
+        if (local.empty()) {
+            refill(local);
+        }
+        if (local.empty()) {
+            return DeviceHandle(new T(), DeviceDeleter{ this });
+        }
+        T* device = local.back();
+        local.pop_back();
+        return DeviceHandle(device, DeviceDeleter{ this });
+    }
+
+    void recycle(Device* device) override {
+        device->reset();
+        std::vector<T*>& local = localCache().items;
+        if (local.size() == LOCAL_CAPACITY) {
+            spill(local, LOCAL_CAPACITY / 2);
+        }
+        local.push_back(static_cast<T*>(device));
+    }
+
+private:
+    // Per-thread free list; whatever is left when the thread exits goes to the shared overflow
+    struct LocalCache {
+        std::vector<T*> items;
+
+        LocalCache() {
+            items.reserve(LOCAL_CAPACITY);
+        }
+
+        ~LocalCache() {
+            TypedDevicePool::instance().spill(items, items.size());
+        }
+    };
+
+    TypedDevicePool() = default;
+
+    LocalCache& localCache() {
+        static thread_local LocalCache cache;
+        return cache;
+    }
+
+    void refill(std::vector<T*>& local) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        size_t count = std::min(m_shared.size(), LOCAL_CAPACITY / 2);
+        local.insert(local.end(), m_shared.end() - count, m_shared.end());
+        m_shared.resize(m_shared.size() - count);
+    }
+
+    void spill(std::vector<T*>& local, size_t count) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shared.insert(m_shared.end(), local.end() - count, local.end());
+        local.resize(local.size() - count);
+    }
+
+    std::mutex m_mutex;
+    std::vector<T*> m_shared;
+};
+
+class DeviceFactory {
+public:
+    static std::unique_ptr<Device> createDevice(const std::string& type) {
+        if ( type == "sensor" ) {
+            return std::make_unique<Sensor>();
+        }
+        else if ( type == "printer" ) {
+            return std::make_unique<Printer>();
+        }
+        else {
+            throw std::invalid_argument("Unknown device type: " + type);
+        }
+    }
+
+    // Pool mode: the handle's deleter recycles the device instead of freeing it
+    static DeviceHandle createPooledDevice(std::string_view type) {
+        if ( type == "sensor" ) {
+            return TypedDevicePool<Sensor>::instance().acquire();
+        }
+        else if ( type == "printer" ) {
+            return TypedDevicePool<Printer>::instance().acquire();
+        }
+        else {
+            throw std::invalid_argument("Unknown device type: " + std::string(type));
+        }
+    }
+};
+
+// Connect / drop churn: every round opens a burst of endpoints and closes them again
+template <typename Create>
+double churn(unsigned threads, size_t rounds, Create create) {
+    const size_t burst = 32;
+    auto work = [&] {
+        using Handle = decltype(create("sensor"));
+        std::vector<Handle> live;
+        live.reserve(burst);
+        for (size_t r = 0; r < rounds; ++r) {
+            for (size_t i = 0; i < burst; ++i) {
+                live.push_back(create(i % 2 ? "sensor" : "printer"));
+            }
+            live.clear();
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(work);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * rounds * burst / elapsed.count() / 1e6;
+}
+
+void benchmark(size_t rounds) {
+    unsigned cores = std::max(2u, std::thread::hardware_concurrency());
+    std::cout << "\nCreate/destroy churn, " << rounds << " rounds of 32 devices per thread" << std::endl;
+    for (unsigned threads : { 1u, cores }) {
+        double plain = churn(threads, rounds, [](const char* type) { return DeviceFactory::createDevice(type); });
+        double pooled = churn(threads, rounds, [](const char* type) { return DeviceFactory::createPooledDevice(type); });
+        std::cout << "  " << threads << " thread(s): make_unique " << plain << " M/s, pool " << pooled << " M/s" << std::endl;
+    }
+}
+
+int main() {
+    // Use factory to create devices
+    auto sensor = DeviceFactory::createPooledDevice("sensor");
+    sensor->connect();
+    Device* first = sensor.get();
+    sensor.reset(); // back to the pool
+
+    auto again = DeviceFactory::createPooledDevice("sensor");
+    std::cout << "Sensor reused from pool: " << (again.get() == first ? "yes" : "no") << std::endl;
+
+    auto printer = DeviceFactory::createPooledDevice("printer");
+    printer->connect();
+
+    benchmark(200000);
+
+    return 0;
+}
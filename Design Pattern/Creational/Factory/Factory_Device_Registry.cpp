@@ -0,0 +1,321 @@
+/*
+A registry-based version of the factories in Factory_1.cpp and Factory_Managing_Diverse_Device.cpp.
+
+Both factories pick the product with a chain of string comparisons and take the type name as a std::string, so every call may
+allocate and the cost grows with the number of types. Here a factory looks the name up in a registry instead:
+
+1. Built-in types (Sensor / Printer, Windows / Linux) are listed in a constexpr table. The compiler searches for a seed that makes
+   the hash of every built-in name land in its own slot (a perfect hash), so a lookup is one hash, one slot and one comparison.
+
+2. Plugin types register themselves at static-init time with REGISTER_DEVICE, and land in a hashed map that is only consulted
+   when the name is not a built-in. A plugin cannot take the name of a built-in or of another plugin: REGISTER_DEVICE reports
+   the clash on std::cerr and the first registration stays in place.
+
+Lookups take a std::string_view, so names sliced out of a configuration buffer never have to be copied into a std::string.
+Registration is not synchronized; it is meant to happen during static initialization, before any lookup.
+
+Build: g++ -std=c++17 -O2 Factory_Device_Registry.cpp
+*/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Registry
+// ---------------------------------------------------------------------------
+
+template <typename Product>
+using Creator = std::unique_ptr<Product> (*)();
+
+template <typename Concrete, typename Product>
+std::unique_ptr<Product> create() {
+    return std::make_unique<Concrete>();
+}
+
+template <typename Product>
+struct RegistryEntry {
+    std::string_view name;
+    Creator<Product> creator;
+};
+
+constexpr std::uint32_t hashName(std::string_view name, std::uint32_t seed) {
+    std::uint32_t hash = 2166136261u ^ seed; // FNV-1a
+    for (char c : name) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+// Collision-free table over a fixed set of names, built at compile time
+template <typename Product, std::size_t N>
+class PerfectHashTable {
+public:
+    static constexpr std::size_t SLOTS = [] {
+        std::size_t slots = 1;
+        while (slots < 2 * N) {
+            slots *= 2;
+        }
+        return slots;
+    }();
+
+    constexpr explicit PerfectHashTable(const std::array<RegistryEntry<Product>, N>& entries)
+        : m_entries(entries) {
+        while (!tryBuild()) {
+            ++m_seed;
+        }
+    }
+
+    Creator<Product> find(std::string_view name) const {
+        int index = m_slots[hashName(name, m_seed) & (SLOTS - 1)];
+        if (index >= 0 && m_entries[index].name == name) {
+            return m_entries[index].creator;
+        }
+        return nullptr;
+    }
+
+private:
+    constexpr bool tryBuild() {
+        for (auto& slot : m_slots) {
+            slot = -1;
+        }
+        for (std::size_t i = 0; i < N; ++i) {
+            int& slot = m_slots[hashName(m_entries[i].name, m_seed) & (SLOTS - 1)];
+            if (slot >= 0) {
+                return false;
+            }
+            slot = static_cast<int>(i);
+        }
+        return true;
+    }
+
+    std::array<RegistryEntry<Product>, N> m_entries;
+    std::array<int, SLOTS> m_slots{};
+    std::uint32_t m_seed = 0;
+};
+
+// Run-time registered types, looked up when a name is not a built-in
+template <typename Product>
+class PluginRegistry {
+public:
+    static PluginRegistry& instance() {
+        static PluginRegistry registry;
+        return registry;
+    }
+
+    // Returns false, and stores nothing, when the name is taken by a built-in or by an earlier plugin
+    template <std::size_t N>
+    bool add(std::string_view name, Creator<Product> creator, const PerfectHashTable<Product, N>& builtins) {
+        if (builtins.find(name) || m_creators.find(name) != m_creators.end()) {
+            return false;
+        }
+        // std::deque never moves its elements, so the views used as keys stay valid
+        const std::string& stored = m_names.emplace_back(name);
+        return m_creators.emplace(stored, creator).second;
+    }
+
+    Creator<Product> find(std::string_view name) const {
+        auto found = m_creators.find(name);
+        return found == m_creators.end() ? nullptr : found->second;
+    }
+
+private:
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string_view, Creator<Product>> m_creators;
+};
+
+// ---------------------------------------------------------------------------
+// Devices (Factory_Managing_Diverse_Device.cpp)
+// ---------------------------------------------------------------------------
+
+class Device {
+public:
+    virtual ~Device() {}
+    virtual void connect() = 0;
+};
+
+class Sensor : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting sensor via I2C protocol..." << std::endl;
+    }
+};
+
+class Printer : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting printer via Bluetooth..." << std::endl;
+    }
+};
+
+constexpr PerfectHashTable<Device, 2> builtinDevices({ {
+    { "sensor", &create<Sensor, Device> },
+    { "printer", &create<Printer, Device> },
+} });
+
+class DeviceFactory {
+public:
+    static std::unique_ptr<Device> createDevice(std::string_view type) {
+        Creator<Device> creator = builtinDevices.find(type);
+        if (!creator) {
+            creator = PluginRegistry<Device>::instance().find(type);
+        }
+        if (!creator) {
+            throw std::invalid_argument("Unknown device type: " + std::string(type));
+        }
+        return creator();
+    }
+};
+
+// Used by REGISTER_DEVICE: a rejected registration is reported, since nothing can check its result at static-init time
+inline bool reportRegistration(std::string_view name, bool added) {
+    if (!added) {
+        std::cerr << "REGISTER_DEVICE: \"" << name << "\" is a built-in or already registered device type" << std::endl;
+    }
+    return added;
+}
+
+// Registers a plugin device type during static initialization
+#define REGISTER_DEVICE(NAME, TYPE) \
+    static const bool TYPE##_registered = \
+        reportRegistration(NAME, PluginRegistry<Device>::instance().add(NAME, &create<TYPE, Device>, builtinDevices))
+
+// A plugin device, registered from its own translation unit in a real program
+class Camera : public Device {
+public:
+    void connect() override {
+        std::cout << "Connecting camera via USB..." << std::endl;
+    }
+};
+REGISTER_DEVICE("camera", Camera);
+
+// ---------------------------------------------------------------------------
+// Fingerprint devices (Factory_1.cpp)
+// ---------------------------------------------------------------------------
+
+class FingerprintDevice {
+public:
+    virtual ~FingerprintDevice() {}
+    virtual void authenticate() = 0;
+};
+
+class WindowsFingerprintDevice : public FingerprintDevice {
+public:
+    void authenticate() override {
+        std::cout << "Authenticating with Windows fingerprint device..." << std::endl;
+    }
+};
+
+class LinuxFingerprintDevice : public FingerprintDevice {
+public:
+    void authenticate() override {
+        std::cout << "Authenticating with Linux fingerprint device..." << std::endl;
+    }
+};
+
+constexpr PerfectHashTable<FingerprintDevice, 2> builtinFingerprintDevices({ {
+    { "Windows", &create<WindowsFingerprintDevice, FingerprintDevice> },
+    { "Linux", &create<LinuxFingerprintDevice, FingerprintDevice> },
+} });
+
+class FingerprintDeviceFactory {
+public:
+    // Returns nullptr for an unknown platform, like the original factory
+    static std::unique_ptr<FingerprintDevice> createDevice(std::string_view platform) {
+        Creator<FingerprintDevice> creator = builtinFingerprintDevices.find(platform);
+        if (!creator) {
+            creator = PluginRegistry<FingerprintDevice>::instance().find(platform);
+        }
+        return creator ? creator() : nullptr;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+// The original lookup: a comparison chain over a std::string argument
+std::unique_ptr<Device> createDeviceByChain(const std::string& type) {
+    if ( type == "sensor" ) {
+        return std::make_unique<Sensor>();
+    }
+    else if ( type == "printer" ) {
+        return std::make_unique<Printer>();
+    }
+    else if ( type == "camera" ) {
+        return std::make_unique<Camera>();
+    }
+    else {
+        throw std::invalid_argument("Unknown device type: " + type);
+    }
+}
+
+void benchmark(size_t endpoints) {
+    using Clock = std::chrono::steady_clock;
+
+    // Endpoint types as they would be sliced out of a configuration file
+    std::string config;
+    const char* types[] = { "sensor", "printer", "camera" };
+    for (size_t i = 0; i < endpoints; ++i) {
+        config.append(types[i % 3]).append("\n");
+    }
+    std::vector<std::string_view> names;
+    std::string_view rest = config;
+    while (!rest.empty()) {
+        size_t end = rest.find('\n');
+        names.push_back(rest.substr(0, end));
+        rest.remove_prefix(end + 1);
+    }
+
+    const int rounds = 100;
+    std::vector<std::unique_ptr<Device>> devices(names.size());
+
+    auto start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            devices[i] = createDeviceByChain(std::string(names[i]));
+        }
+    }
+    std::chrono::duration<double> chainTime = Clock::now() - start;
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            devices[i] = DeviceFactory::createDevice(names[i]);
+        }
+    }
+    std::chrono::duration<double> registryTime = Clock::now() - start;
+
+    size_t calls = names.size() * rounds;
+    std::cout << "\n" << names.size() << " endpoints x " << rounds << " rounds" << std::endl;
+    std::cout << "  string comparison chain : " << calls / chainTime.count() / 1e6 << " M devices/s" << std::endl;
+    std::cout << "  registry                : " << calls / registryTime.count() / 1e6 << " M devices/s" << std::endl;
+}
+
+int main() {
+    // Use factory to create devices
+    auto sensor = DeviceFactory::createDevice("sensor");
+    sensor->connect();
+
+    auto printer = DeviceFactory::createDevice("printer");
+    printer->connect();
+
+    // Plugin type, found through the run-time registry
+    auto camera = DeviceFactory::createDevice("camera");
+    camera->connect();
+
+    auto windowsDevice = FingerprintDeviceFactory::createDevice("Windows");
+    windowsDevice->authenticate();
+
+    benchmark(50000);
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+/*
+Non-allocating read path for the Car prototypes of Prototype_1.cpp.
+
+The string getters of Car return std::string by value through a virtual call, so scanning a fleet for one field allocates a copy
+of that field for every car. This sample adds two cheaper ways to read:
+
+1. View getters: brandView(), modelView(), colorView() and vinView() return a std::string_view of the stored field. Still one
+   virtual call per read, but no allocation. The view is valid until the field is set again or the car is destroyed.
+
+2. FleetIndex: a visitor (CarVisitor / Car::accept) tags every car with its concrete type, once. forEach() then walks the cars
+   in their original order and hands each one to the callback as its concrete type, so for `final` classes the reads are direct,
+   inlinable calls. Adding a concrete car type means adding a visit() overload and a tag.
+
+The benchmark filters 10M cars by VIN prefix with the old getters, the view getters and the index.
+
+Build: g++ -std=c++17 -O2 Prototype_Accessors.cpp
+*/
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class Sedan;
+class Hatchback;
+
+class CarVisitor
+{
+public:
+    virtual ~CarVisitor() {}
+    virtual void visit(const Sedan& car) = 0;
+    virtual void visit(const Hatchback& car) = 0;
+};
+
+class Car
+{
+public:
+    virtual ~Car() {}
+
+    virtual std::unique_ptr<Car> clone() = 0;
+
+    virtual void print() const = 0;
+
+    // Double dispatch to the concrete type
+    virtual void accept(CarVisitor& visitor) const = 0;
+
+    // Getters and setters for the car properties
+    virtual std::string getBrand() const = 0;
+    virtual void setBrand(const std::string& brand) = 0;
+
+    virtual std::string getModel() const = 0;
+    virtual void setModel(const std::string& model) = 0;
+
+    virtual int getYear() const = 0;
+    virtual void setYear(int year) = 0;
+
+    virtual int getMileage() const = 0;
+    virtual void setMileage(int mileage) = 0;
+
+    virtual std::string getColor() const = 0;
+    virtual void setColor(const std::string& color) = 0;
+
+    virtual std::string getVIN() const = 0;
+    virtual void setVIN(const std::string& vin) = 0;
+
+    // Non-allocating getters; the view is valid until the field changes or the car is destroyed
+    virtual std::string_view brandView() const = 0;
+    virtual std::string_view modelView() const = 0;
+    virtual std::string_view colorView() const = 0;
+    virtual std::string_view vinView() const = 0;
+};
+
+// Storage and accessors shared by the concrete cars
+template <typename Derived>
+class CarBase : public Car
+{
+public:
+    std::unique_ptr<Car> clone() override
+    {
+        return std::make_unique<Derived>(static_cast<const Derived&>(*this));
+    }
+
+    void accept(CarVisitor& visitor) const override
+    {
+        visitor.visit(static_cast<const Derived&>(*this));
+    }
+
+    void print() const override
+    {
+        std::cout << Derived::KIND << " - Brand: " << m_brand
+                  << ", Model: " << m_model
+                  << ", Year: " << m_year
+                  << ", Mileage: " << m_mileage
+                  << ", Color: " << m_color
+                  << ", VIN: " << m_vin
+                  << std::endl;
+    }
+
+    // Getters and setters for the car properties
+    std::string getBrand() const override { return m_brand; }
+    void setBrand(const std::string& brand) override { m_brand = brand; }
+
+    std::string getModel() const override { return m_model; }
+    void setModel(const std::string& model) override { m_model = model; }
+
+    int getYear() const override { return m_year; }
+    void setYear(int year) override { m_year = year; }
+
+    int getMileage() const override { return m_mileage; }
+    void setMileage(int mileage) override { m_mileage = mileage; }
+
+    std::string getColor() const override { return m_color; }
+    void setColor(const std::string& color) override { m_color = color; }
+
+    std::string getVIN() const override { return m_vin; }
+    void setVIN(const std::string& vin) override { m_vin = vin; }
+
+    std::string_view brandView() const override { return m_brand; }
+    std::string_view modelView() const override { return m_model; }
+    std::string_view colorView() const override { return m_color; }
+    std::string_view vinView() const override { return m_vin; }
+
+private:
+    std::string m_brand;
+    std::string m_model;
+    int m_year = 0;
+    int m_mileage = 0;
+    std::string m_color;
+    std::string m_vin;
+};
+
+class Sedan final : public CarBase<Sedan>
+{
+public:
+    static constexpr const char* KIND = "Sedan";
+};
+
+class Hatchback final : public CarBase<Hatchback>
+{
+public:
+    static constexpr const char* KIND = "Hatchback";
+};
+
+// Cars tagged with their concrete type, so scans know the type of every car they read
+class FleetIndex : private CarVisitor
+{
+public:
+    template <typename Range>
+    explicit FleetIndex(const Range& cars)
+    {
+        m_entries.reserve(cars.size());
+        for (const auto& car : cars) {
+            car->accept(*this);
+        }
+    }
+
+    // Calls visit(car) with every car as its concrete type, in the original order
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const
+    {
+        for (const Entry& entry : m_entries) {
+            switch (entry.kind) {
+            case Kind::Sedan:
+                visit(static_cast<const Sedan&>(*entry.car));
+                break;
+            case Kind::Hatchback:
+                visit(static_cast<const Hatchback&>(*entry.car));
+                break;
+            }
+        }
+    }
+
+    size_t size() const { return m_entries.size(); }
+
+private:
+    enum class Kind { Sedan, Hatchback };
+
+    struct Entry {
+        Kind kind;
+        const Car* car;
+    };
+
+    void visit(const Sedan& car) override { m_entries.push_back({ Kind::Sedan, &car }); }
+    void visit(const Hatchback& car) override { m_entries.push_back({ Kind::Hatchback, &car }); }
+
+    std::vector<Entry> m_entries;
+};
+
+bool startsWith(std::string_view text, std::string_view prefix)
+{
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+void benchmark(size_t count)
+{
+    using Clock = std::chrono::steady_clock;
+
+    Sedan sedan;
+    sedan.setBrand("Toyota");
+    sedan.setModel("Camry");
+    Hatchback hatchback;
+    hatchback.setBrand("Volkswagen");
+    hatchback.setModel("Golf");
+
+    std::vector<std::unique_ptr<Car>> fleet;
+    fleet.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::unique_ptr<Car> car = i % 3 ? sedan.clone() : hatchback.clone();
+        car->setVIN((i % 7 ? "4T1B21HK5M" : "WVWZZZ1KZA") + std::to_string(1000000 + i % 9000000));
+        fleet.push_back(std::move(car));
+    }
+
+    const std::string prefix = "WVWZZZ";
+    auto report = [count](const char* label, size_t matches, std::chrono::duration<double> elapsed) {
+        std::cout << "  " << label << count / elapsed.count() / 1e6 << " M cars/s (" << matches << " matches)" << std::endl;
+    };
+
+    std::cout << "\nFiltering " << count << " cars by VIN prefix" << std::endl;
+
+    auto start = Clock::now();
+    size_t matches = 0;
+    for (auto& car : fleet) {
+        matches += startsWith(car->getVIN(), prefix);
+    }
+    report("getVIN()    : ", matches, Clock::now() - start);
+
+    start = Clock::now();
+    matches = 0;
+    for (auto& car : fleet) {
+        matches += startsWith(car->vinView(), prefix);
+    }
+    report("vinView()   : ", matches, Clock::now() - start);
+
+    start = Clock::now();
+    FleetIndex index(fleet);
+    std::chrono::duration<double> indexTime = Clock::now() - start;
+
+    start = Clock::now();
+    matches = 0;
+    index.forEach([&](const auto& car) { matches += startsWith(car.vinView(), prefix); });
+    report("FleetIndex  : ", matches, Clock::now() - start);
+    std::cout << "  (index built once in " << indexTime.count() * 1000 << " ms)" << std::endl;
+}
+
+int main()
+{
+    // Create a prototype Sedan object
+    std::unique_ptr<Sedan> sedanPrototype = std::make_unique<Sedan>();
+    sedanPrototype->setBrand("Toyota");
+    sedanPrototype->setModel("Camry");
+    sedanPrototype->setYear(2021);
+    sedanPrototype->setMileage(0);
+    sedanPrototype->setColor("White");
+    sedanPrototype->setVIN("ABC123");
+
+    // Clone the prototype and customize the clone
+    std::unique_ptr<Car> myCar = sedanPrototype->clone();
+    myCar->setMileage(1000);
+    myCar->setColor("Red");
+
+    // Read without copying
+    std::cout << "Clone color: " << myCar->colorView() << ", VIN: " << myCar->vinView() << std::endl;
+
+    std::vector<std::unique_ptr<Car>> cars;
+    cars.push_back(std::move(myCar));
+    cars.push_back(std::make_unique<Hatchback>());
+    cars.back()->setVIN("WVW456");
+    FleetIndex index(cars);
+    index.forEach([](const auto& car) { car.print(); });
+
+    benchmark(10000000);
+
+    return 0;
+}
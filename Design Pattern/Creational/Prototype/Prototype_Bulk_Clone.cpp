@@ -0,0 +1,356 @@
+/*
+Bulk cloning for the Car prototype hierarchy of Prototype_1.cpp.
+
+Cloning a prototype n times with clone() means n separate make_unique allocations scattered through the heap, and walking the
+clones afterwards chases a pointer and makes a virtual call per car. cloneN(n) instead copies the prototype n times into one
+contiguous slab of its concrete type and returns it as a CarBatch:
+
+- batch[i] / handle(i) give the i-th clone as a Car&, or as a CarHandle (slab + index, 16 bytes) that can be stored and passed
+  around instead of a unique_ptr;
+- CarSlab<T>::forEach() walks the clones as their concrete type, so the calls can be inlined;
+- for very large n the copies can be split across threads, each filling its own part of the slab.
+
+Every concrete car gets cloneN() by deriving from CloneableCar<Derived>, the same way it gets clone(). The Mustang / Camaro
+hierarchy of Prototype_2.cpp (namespace described) gets it the same way, through CloneableCar<Derived, described::Car>.
+The slab owns its clones: handles and references are valid as long as the batch is alive. If a copy throws, the clones made so
+far are destroyed and the exception is rethrown by cloneN().
+
+Build: g++ -std=c++17 -O2 -pthread Prototype_Bulk_Clone.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Car;
+
+// Clones produced by one cloneN() call, stored contiguously
+template <typename Base>
+class Batch
+{
+public:
+    virtual ~Batch() {}
+    virtual size_t size() const = 0;
+    virtual Base& operator[](size_t index) = 0;
+};
+
+// Lightweight reference to one clone of a batch
+template <typename Base>
+class Handle
+{
+public:
+    Handle(Batch<Base>* batch, size_t index) : m_batch(batch), m_index(index) {}
+
+    Base& operator*() const { return (*m_batch)[m_index]; }
+    Base* operator->() const { return &(*m_batch)[m_index]; }
+
+private:
+    Batch<Base>* m_batch;
+    size_t m_index;
+};
+
+using CarBatch = Batch<Car>;
+using CarHandle = Handle<Car>;
+
+class Car
+{
+public:
+    virtual ~Car() {}
+
+    virtual std::unique_ptr<Car> clone() = 0;
+
+    // n copies of this car in one contiguous block, built on up to `threads` threads
+    virtual std::unique_ptr<CarBatch> cloneN(size_t n, unsigned threads = 1) = 0;
+
+    virtual void print() const = 0;
+
+    // Getters and setters for the car properties
+    virtual std::string getBrand() const = 0;
+    virtual void setBrand(const std::string& brand) = 0;
+
+    virtual std::string getModel() const = 0;
+    virtual void setModel(const std::string& model) = 0;
+
+    virtual int getYear() const = 0;
+    virtual void setYear(int year) = 0;
+
+    virtual int getMileage() const = 0;
+    virtual void setMileage(int mileage) = 0;
+
+    virtual std::string getColor() const = 0;
+    virtual void setColor(const std::string& color) = 0;
+
+    virtual std::string getVIN() const = 0;
+    virtual void setVIN(const std::string& vin) = 0;
+};
+
+template <typename T, typename Base = Car>
+class CarSlab : public Batch<Base>
+{
+public:
+    CarSlab(const T& prototype, size_t n, unsigned threads)
+        : m_cars(std::allocator<T>().allocate(n)), m_size(n)
+    {
+        threads = std::max(1u, std::min<unsigned>(threads, static_cast<unsigned>(n / MIN_PER_THREAD + 1)));
+        size_t chunk = n / threads;
+        std::vector<std::exception_ptr> errors(threads);
+        std::vector<char> filled(threads, 0);
+
+        // uninitialized_fill cleans up its own range when a copy throws; the other ranges are destroyed below
+        auto fill = [&](unsigned t) {
+            T* first = m_cars + t * chunk;
+            T* last = t + 1 == threads ? m_cars + n : first + chunk;
+            try {
+                std::uninitialized_fill(first, last, prototype);
+                filled[t] = 1;
+            }
+            catch (...) {
+                errors[t] = std::current_exception();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        try {
+            for (unsigned t = 0; t + 1 < threads; ++t) {
+                workers.emplace_back(fill, t);
+            }
+            fill(threads - 1); // the calling thread fills the last part
+        }
+        catch (...) {
+            errors.back() = std::current_exception(); // a thread could not be started
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+
+        for (auto& error : errors) {
+            if (error) {
+                for (unsigned t = 0; t < threads; ++t) {
+                    if (filled[t]) {
+                        std::destroy(m_cars + t * chunk, t + 1 == threads ? m_cars + n : m_cars + (t + 1) * chunk);
+                    }
+                }
+                std::allocator<T>().deallocate(m_cars, m_size);
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    ~CarSlab()
+    {
+        std::destroy(m_cars, m_cars + m_size);
+        std::allocator<T>().deallocate(m_cars, m_size);
+    }
+
+    CarSlab(const CarSlab&) = delete;
+    CarSlab& operator=(const CarSlab&) = delete;
+
+    size_t size() const override { return m_size; }
+    T& operator[](size_t index) override { return m_cars[index]; }
+
+    Handle<Base> handle(size_t index) { return Handle<Base>(this, index); }
+
+    // Visits the clones as their concrete type, without virtual dispatch
+    template <typename Visitor>
+    void forEach(Visitor&& visit)
+    {
+        for (T* car = m_cars; car != m_cars + m_size; ++car) {
+            visit(*car);
+        }
+    }
+
+private:
+    static constexpr size_t MIN_PER_THREAD = 4096; // below this a thread costs more than it saves
+
+    T* m_cars;
+    size_t m_size;
+};
+
+// Gives a concrete car clone() and cloneN()
+template <typename Derived, typename Base = Car>
+class CloneableCar : public Base
+{
+public:
+    std::unique_ptr<Base> clone() override
+    {
+        return std::make_unique<Derived>(static_cast<const Derived&>(*this));
+    }
+
+    std::unique_ptr<Batch<Base>> cloneN(size_t n, unsigned threads = 1) override
+    {
+        return cloneSlab(n, threads);
+    }
+
+    // Same as cloneN(), typed, so forEach() can see the concrete car
+    std::unique_ptr<CarSlab<Derived, Base>> cloneSlab(size_t n, unsigned threads = 1)
+    {
+        return std::make_unique<CarSlab<Derived, Base>>(static_cast<const Derived&>(*this), n, threads);
+    }
+};
+
+class Sedan final : public CloneableCar<Sedan>
+{
+public:
+    void print() const override
+    {
+        std::cout << "Sedan - Brand: " << m_brand
+                  << ", Model: " << m_model
+                  << ", Year: " << m_year
+                  << ", Mileage: " << m_mileage
+                  << ", Color: " << m_color
+                  << ", VIN: " << m_vin
+                  << std::endl;
+    }
+
+    // Getters and setters for the car properties
+    std::string getBrand() const override { return m_brand; }
+    void setBrand(const std::string& brand) override { m_brand = brand; }
+
+    std::string getModel() const override { return m_model; }
+    void setModel(const std::string& model) override { m_model = model; }
+
+    int getYear() const override { return m_year; }
+    void setYear(int year) override { m_year = year; }
+
+    int getMileage() const override { return m_mileage; }
+    void setMileage(int mileage) override { m_mileage = mileage; }
+
+    std::string getColor() const override { return m_color; }
+    void setColor(const std::string& color) override { m_color = color; }
+
+    std::string getVIN() const override { return m_vin; }
+    void setVIN(const std::string& vin) override { m_vin = vin; }
+
+private:
+    std::string m_brand;
+    std::string m_model;
+    int m_year = 0;
+    int m_mileage = 0;
+    std::string m_color;
+    std::string m_vin;
+};
+
+// The Mustang / Camaro prototypes of Prototype_2.cpp, with the same bulk cloning
+namespace described
+{
+    class Car
+    {
+    public:
+        virtual ~Car() {}
+
+        virtual std::unique_ptr<Car> clone() = 0;
+
+        // n copies of this car in one contiguous block, built on up to `threads` threads
+        virtual std::unique_ptr<Batch<Car>> cloneN(size_t n, unsigned threads = 1) = 0;
+
+        virtual void setDescription(const std::string& description)
+        {
+            m_description = description;
+        }
+
+        virtual std::string getDescription() const
+        {
+            return m_description;
+        }
+
+    private:
+        std::string m_description;
+    };
+
+    class Mustang final : public CloneableCar<Mustang, Car>
+    {
+    };
+
+    class Camaro final : public CloneableCar<Camaro, Car>
+    {
+    };
+}
+
+void benchmark(Sedan& prototype, size_t count)
+{
+    using Clock = std::chrono::steady_clock;
+    auto rate = [count](std::chrono::duration<double> elapsed) { return count / elapsed.count() / 1e6; };
+
+    auto start = Clock::now();
+    std::vector<std::unique_ptr<Car>> individual;
+    individual.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        individual.push_back(prototype.clone());
+    }
+    auto cloneIndividual = rate(Clock::now() - start);
+
+    start = Clock::now();
+    auto slab = prototype.cloneSlab(count);
+    auto cloneSlab = rate(Clock::now() - start);
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    start = Clock::now();
+    auto parallelSlab = prototype.cloneSlab(count, cores);
+    auto cloneParallel = rate(Clock::now() - start);
+
+    start = Clock::now();
+    long long total = 0;
+    for (auto& car : individual) {
+        total += car->getMileage();
+    }
+    auto iterateIndividual = rate(Clock::now() - start);
+
+    start = Clock::now();
+    long long slabTotal = 0;
+    slab->forEach([&slabTotal](const Sedan& car) { slabTotal += car.getMileage(); });
+    auto iterateSlab = rate(Clock::now() - start);
+
+    std::cout << "\n" << count << " clones" << std::endl;
+    std::cout << "  unique_ptr clones : " << cloneIndividual << " M clones/s, iterate " << iterateIndividual
+              << " M cars/s (" << total << ")" << std::endl;
+    std::cout << "  cloneN            : " << cloneSlab << " M clones/s, iterate " << iterateSlab
+              << " M cars/s (" << slabTotal << ")" << std::endl;
+    std::cout << "  cloneN x" << cores << " threads : " << cloneParallel << " M clones/s" << std::endl;
+}
+
+int main()
+{
+    // Create a prototype Sedan object
+    std::unique_ptr<Sedan> sedanPrototype = std::make_unique<Sedan>();
+    sedanPrototype->setBrand("Toyota");
+    sedanPrototype->setModel("Camry");
+    sedanPrototype->setYear(2021);
+    sedanPrototype->setMileage(0);
+    sedanPrototype->setColor("White");
+    sedanPrototype->setVIN("ABC123");
+
+    // Clone the prototype three times into one block and customize the clones
+    std::unique_ptr<CarBatch> fleet = sedanPrototype->cloneN(3);
+    for (size_t i = 0; i < fleet->size(); ++i) {
+        (*fleet)[i].setMileage(1000 * static_cast<int>(i + 1));
+    }
+
+    CarHandle red(fleet.get(), 1);
+    red->setColor("Red");
+
+    std::cout << "Prototype Sedan:" << std::endl;
+    sedanPrototype->print();
+    std::cout << "Cloned Sedans:" << std::endl;
+    for (size_t i = 0; i < fleet->size(); ++i) {
+        (*fleet)[i].print();
+    }
+
+    // Prototype_2.cpp: three Mustangs in one block, one of them repainted as a Camaro description
+    described::Mustang mustang;
+    mustang.setDescription("This is a Ford Mustang.");
+    std::unique_ptr<Batch<described::Car>> mustangs = mustang.cloneN(3);
+    Handle<described::Car> third(mustangs.get(), 2);
+    third->setDescription("This is a Chevrolet Camaro.");
+    for (size_t i = 0; i < mustangs->size(); ++i) {
+        std::cout << (*mustangs)[i].getDescription() << "\n";
+    }
+
+    benchmark(*sedanPrototype, 2000000);
+
+    return 0;
+}
@@ -0,0 +1,303 @@
+/*
+Copy-on-write fields for the Sedan prototype of Prototype_1.cpp.
+
+Sedan::clone() deep-copies every string field, although most clones only change mileage and color and keep the brand, model and
+VIN of their prototype. CowSedan stores its string fields as CowString: a pointer to an immutable, reference-counted buffer.
+Cloning copies the pointers and bumps the counts, so every clone shares the prototype's payloads. A setter detaches only the field
+it changes, by pointing it at a new buffer; the other fields stay shared.
+
+The reference count is atomic, so clones of one prototype can be created and destroyed from different threads. A CowString is a
+single pointer (8 bytes instead of 32 for std::string) and its characters live in the same allocation as the count.
+
+Build: g++ -std=c++17 -O2 Prototype_Copy_On_Write.cpp
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Immutable string payload shared between copies; copying only bumps a reference count
+class CowString
+{
+public:
+    CowString() = default;
+
+    CowString(std::string_view text)
+    {
+        if (!text.empty()) {
+            void* memory = ::operator new(sizeof(Payload) + text.size());
+            m_payload = new (memory) Payload{ { 1 }, text.size() };
+            std::memcpy(m_payload->chars(), text.data(), text.size());
+        }
+    }
+
+    CowString(const CowString& other)
+        : m_payload(other.m_payload)
+    {
+        if (m_payload) {
+            m_payload->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowString(CowString&& other) noexcept
+        : m_payload(other.m_payload)
+    {
+        other.m_payload = nullptr;
+    }
+
+    CowString& operator=(CowString other) noexcept
+    {
+        std::swap(m_payload, other.m_payload);
+        return *this;
+    }
+
+    ~CowString()
+    {
+        if (m_payload && m_payload->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_payload->~Payload();
+            ::operator delete(m_payload);
+        }
+    }
+
+    std::string_view view() const
+    {
+        return m_payload ? std::string_view(m_payload->chars(), m_payload->size) : std::string_view();
+    }
+
+    std::string str() const { return std::string(view()); }
+
+    // True when this field still shares its buffer with another copy
+    bool shared() const
+    {
+        return m_payload && m_payload->refs.load(std::memory_order_relaxed) > 1;
+    }
+
+    // Detaches this field only when the value actually changes
+    void assign(std::string_view text)
+    {
+        if (view() != text) {
+            *this = CowString(text);
+        }
+    }
+
+private:
+    struct Payload {
+        std::atomic<long> refs;
+        size_t size;
+        char* chars() { return reinterpret_cast<char*>(this + 1); }
+    };
+
+    Payload* m_payload = nullptr;
+};
+
+class Car
+{
+public:
+    virtual ~Car() {}
+
+    virtual std::unique_ptr<Car> clone() = 0;
+
+    virtual void print() const = 0;
+
+    // Getters and setters for the car properties
+    virtual std::string getBrand() const = 0;
+    virtual void setBrand(const std::string& brand) = 0;
+
+    virtual std::string getModel() const = 0;
+    virtual void setModel(const std::string& model) = 0;
+
+    virtual int getYear() const = 0;
+    virtual void setYear(int year) = 0;
+
+    virtual int getMileage() const = 0;
+    virtual void setMileage(int mileage) = 0;
+
+    virtual std::string getColor() const = 0;
+    virtual void setColor(const std::string& color) = 0;
+
+    virtual std::string getVIN() const = 0;
+    virtual void setVIN(const std::string& vin) = 0;
+};
+
+// Deep-copying sedan, as in Prototype_1.cpp
+class Sedan : public Car
+{
+public:
+    std::unique_ptr<Car> clone() override
+    {
+        return std::make_unique<Sedan>(*this);
+    }
+
+    void print() const override
+    {
+        std::cout << "Sedan - Brand: " << m_brand
+                  << ", Model: " << m_model
+                  << ", Year: " << m_year
+                  << ", Mileage: " << m_mileage
+                  << ", Color: " << m_color
+                  << ", VIN: " << m_vin
+                  << std::endl;
+    }
+
+    std::string getBrand() const override { return m_brand; }
+    void setBrand(const std::string& brand) override { m_brand = brand; }
+
+    std::string getModel() const override { return m_model; }
+    void setModel(const std::string& model) override { m_model = model; }
+
+    int getYear() const override { return m_year; }
+    void setYear(int year) override { m_year = year; }
+
+    int getMileage() const override { return m_mileage; }
+    void setMileage(int mileage) override { m_mileage = mileage; }
+
+    std::string getColor() const override { return m_color; }
+    void setColor(const std::string& color) override { m_color = color; }
+
+    std::string getVIN() const override { return m_vin; }
+    void setVIN(const std::string& vin) override { m_vin = vin; }
+
+private:
+    std::string m_brand;
+    std::string m_model;
+    int m_year = 0;
+    int m_mileage = 0;
+    std::string m_color;
+    std::string m_vin;
+};
+
+// Copy-on-write sedan: clones share the string payloads of their prototype
+class CowSedan : public Car
+{
+public:
+    std::unique_ptr<Car> clone() override
+    {
+        return std::make_unique<CowSedan>(*this);
+    }
+
+    void print() const override
+    {
+        std::cout << "Sedan - Brand: " << m_brand.view()
+                  << ", Model: " << m_model.view()
+                  << ", Year: " << m_year
+                  << ", Mileage: " << m_mileage
+                  << ", Color: " << m_color.view()
+                  << ", VIN: " << m_vin.view()
+                  << std::endl;
+    }
+
+    std::string getBrand() const override { return m_brand.str(); }
+    void setBrand(const std::string& brand) override { m_brand.assign(brand); }
+
+    std::string getModel() const override { return m_model.str(); }
+    void setModel(const std::string& model) override { m_model.assign(model); }
+
+    int getYear() const override { return m_year; }
+    void setYear(int year) override { m_year = year; }
+
+    int getMileage() const override { return m_mileage; }
+    void setMileage(int mileage) override { m_mileage = mileage; }
+
+    std::string getColor() const override { return m_color.str(); }
+    void setColor(const std::string& color) override { m_color.assign(color); }
+
+    std::string getVIN() const override { return m_vin.str(); }
+    void setVIN(const std::string& vin) override { m_vin.assign(vin); }
+
+    bool sharesColor() const { return m_color.shared(); }
+
+private:
+    CowString m_brand;
+    CowString m_model;
+    int m_year = 0;
+    int m_mileage = 0;
+    CowString m_color;
+    CowString m_vin;
+};
+
+// Resident set size in kilobytes (Linux only, 0 elsewhere)
+long residentKb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            long kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+// Returns the clones so that the next measurement cannot reuse their memory
+template <typename SedanType>
+std::vector<std::unique_ptr<Car>> measure(const char* label, size_t count)
+{
+    SedanType prototype;
+    prototype.setBrand("Toyota");
+    prototype.setModel("Camry Hybrid XLE");
+    prototype.setYear(2021);
+    prototype.setMileage(0);
+    prototype.setColor("Midnight Black Metallic");
+    prototype.setVIN("4T1B21HK5MU012345");
+
+    const std::string colors[] = { "Midnight Black Metallic", "Super White", "Celestial Silver Metallic" };
+    std::vector<std::unique_ptr<Car>> inventory;
+    inventory.reserve(count);
+
+    long before = residentKb();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        std::unique_ptr<Car> car = prototype.clone();
+        car->setMileage(static_cast<int>(i % 100000));
+        car->setColor(colors[i % 3]);
+        inventory.push_back(std::move(car));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    long used = residentKb() - before;
+
+    std::cout << "  " << label << elapsed.count() * 1e9 / count << " ns/clone, "
+              << used * 1024.0 / count << " bytes/clone resident" << std::endl;
+    return inventory;
+}
+
+int main()
+{
+    // Create a prototype Sedan object
+    std::unique_ptr<CowSedan> sedanPrototype = std::make_unique<CowSedan>();
+    sedanPrototype->setBrand("Toyota");
+    sedanPrototype->setModel("Camry");
+    sedanPrototype->setYear(2021);
+    sedanPrototype->setMileage(0);
+    sedanPrototype->setColor("White");
+    sedanPrototype->setVIN("ABC123");
+
+    // Clone the prototype: every string field is shared with the prototype
+    std::unique_ptr<Car> myCar = sedanPrototype->clone();
+    std::cout << "Clone shares color: " << static_cast<CowSedan&>(*myCar).sharesColor() << std::endl;
+
+    // Customize the clone: only the color detaches
+    myCar->setMileage(1000);
+    myCar->setColor("Red");
+    std::cout << "Clone shares color after setColor: " << static_cast<CowSedan&>(*myCar).sharesColor() << std::endl;
+
+    std::cout << "Prototype Sedan:" << std::endl;
+    sedanPrototype->print();
+    std::cout << "Customized Sedan:" << std::endl;
+    myCar->print();
+
+    const size_t count = 2000000;
+    std::cout << "\n" << count << " clones with new mileage and color" << std::endl;
+    auto cowInventory = measure<CowSedan>("copy-on-write : ", count);
+    auto deepInventory = measure<Sedan>("deep copy     : ", count);
+
+    return 0;
+}
@@ -0,0 +1,321 @@
+/*
+Delta-encoded clones for the Car prototype of Prototype_1.cpp.
+
+A clone made with clone() carries a full copy of every field of its prototype, even when it only changes one of them (in
+Prototype_2.cpp a Camaro cloned from a Mustang even keeps its own copy of the description it then overwrites). In a fleet
+where almost every clone is identical to its prototype, that is mostly duplicated data. A DeltaCar stores only what differs:
+
+- a pointer to its parent prototype, which lives in a PrototypeRegistry;
+- the fields that were set on the clone (a bit per field, the two int fields inline, strings in a small sparse list).
+
+Every getter returns the overridden value when there is one and falls through to the parent otherwise. A clone of a DeltaCar
+copies the overrides and keeps the same parent, so lookups never walk a chain. When a clone has diverged so far that the parent
+saves nothing, flatten() turns it into a standalone Sedan.
+
+The registry owns the prototypes; it has to outlive every DeltaCar cloned from it.
+
+Build: g++ -std=c++17 -O2 Prototype_Delta_Clone.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Car
+{
+public:
+    virtual ~Car() {}
+
+    virtual std::unique_ptr<Car> clone() = 0;
+
+    virtual void print() const = 0;
+
+    // Getters and setters for the car properties
+    virtual std::string getBrand() const = 0;
+    virtual void setBrand(const std::string& brand) = 0;
+
+    virtual std::string getModel() const = 0;
+    virtual void setModel(const std::string& model) = 0;
+
+    virtual int getYear() const = 0;
+    virtual void setYear(int year) = 0;
+
+    virtual int getMileage() const = 0;
+    virtual void setMileage(int mileage) = 0;
+
+    virtual std::string getColor() const = 0;
+    virtual void setColor(const std::string& color) = 0;
+
+    virtual std::string getVIN() const = 0;
+    virtual void setVIN(const std::string& vin) = 0;
+};
+
+class Sedan : public Car
+{
+public:
+    std::unique_ptr<Car> clone() override
+    {
+        return std::make_unique<Sedan>(*this);
+    }
+
+    void print() const override
+    {
+        std::cout << "Sedan - Brand: " << m_brand
+                  << ", Model: " << m_model
+                  << ", Year: " << m_year
+                  << ", Mileage: " << m_mileage
+                  << ", Color: " << m_color
+                  << ", VIN: " << m_vin
+                  << std::endl;
+    }
+
+    // Getters and setters for the car properties
+    std::string getBrand() const override { return m_brand; }
+    void setBrand(const std::string& brand) override { m_brand = brand; }
+
+    std::string getModel() const override { return m_model; }
+    void setModel(const std::string& model) override { m_model = model; }
+
+    int getYear() const override { return m_year; }
+    void setYear(int year) override { m_year = year; }
+
+    int getMileage() const override { return m_mileage; }
+    void setMileage(int mileage) override { m_mileage = mileage; }
+
+    std::string getColor() const override { return m_color; }
+    void setColor(const std::string& color) override { m_color = color; }
+
+    std::string getVIN() const override { return m_vin; }
+    void setVIN(const std::string& vin) override { m_vin = vin; }
+
+private:
+    std::string m_brand;
+    std::string m_model;
+    int m_year = 0;
+    int m_mileage = 0;
+    std::string m_color;
+    std::string m_vin;
+};
+
+// Clone that stores only the fields it overrides; everything else is read from its parent
+class DeltaCar : public Car
+{
+public:
+    explicit DeltaCar(const Car* parent) : m_parent(parent) {}
+
+    std::unique_ptr<Car> clone() override
+    {
+        return std::make_unique<DeltaCar>(*this);
+    }
+
+    void print() const override
+    {
+        std::cout << "Sedan - Brand: " << getBrand()
+                  << ", Model: " << getModel()
+                  << ", Year: " << getYear()
+                  << ", Mileage: " << getMileage()
+                  << ", Color: " << getColor()
+                  << ", VIN: " << getVIN()
+                  << " (" << overrideCount() << " overrides)"
+                  << std::endl;
+    }
+
+    std::string getBrand() const override { return getString(BRAND, &Car::getBrand); }
+    void setBrand(const std::string& brand) override { setString(BRAND, brand); }
+
+    std::string getModel() const override { return getString(MODEL, &Car::getModel); }
+    void setModel(const std::string& model) override { setString(MODEL, model); }
+
+    int getYear() const override { return has(YEAR) ? m_year : m_parent->getYear(); }
+    void setYear(int year) override { m_year = year; m_overrides |= YEAR; }
+
+    int getMileage() const override { return has(MILEAGE) ? m_mileage : m_parent->getMileage(); }
+    void setMileage(int mileage) override { m_mileage = mileage; m_overrides |= MILEAGE; }
+
+    std::string getColor() const override { return getString(COLOR, &Car::getColor); }
+    void setColor(const std::string& color) override { setString(COLOR, color); }
+
+    std::string getVIN() const override { return getString(VIN, &Car::getVIN); }
+    void setVIN(const std::string& vin) override { setString(VIN, vin); }
+
+    size_t overrideCount() const
+    {
+        size_t count = 0;
+        for (std::uint8_t bits = m_overrides; bits; bits &= bits - 1) {
+            ++count;
+        }
+        return count;
+    }
+
+    // Standalone copy with every field materialized, for clones that diverged from their parent
+    std::unique_ptr<Sedan> flatten() const
+    {
+        auto car = std::make_unique<Sedan>();
+        car->setBrand(getBrand());
+        car->setModel(getModel());
+        car->setYear(getYear());
+        car->setMileage(getMileage());
+        car->setColor(getColor());
+        car->setVIN(getVIN());
+        return car;
+    }
+
+private:
+    enum Field : std::uint8_t {
+        BRAND = 1 << 0,
+        MODEL = 1 << 1,
+        YEAR = 1 << 2,
+        MILEAGE = 1 << 3,
+        COLOR = 1 << 4,
+        VIN = 1 << 5,
+    };
+
+    bool has(Field field) const { return (m_overrides & field) != 0; }
+
+    std::string getString(Field field, std::string (Car::*parentGetter)() const) const
+    {
+        if (has(field)) {
+            for (auto& entry : m_strings) {
+                if (entry.first == field) {
+                    return entry.second;
+                }
+            }
+        }
+        return (m_parent->*parentGetter)();
+    }
+
+    void setString(Field field, const std::string& value)
+    {
+        if (has(field)) {
+            for (auto& entry : m_strings) {
+                if (entry.first == field) {
+                    entry.second = value;
+                    return;
+                }
+            }
+        }
+        m_strings.emplace_back(field, value);
+        m_overrides |= field;
+    }
+
+    const Car* m_parent;
+    std::uint8_t m_overrides = 0;
+    int m_year = 0;
+    int m_mileage = 0;
+    std::vector<std::pair<Field, std::string>> m_strings;
+};
+
+// Owns the prototypes that delta clones point to
+class PrototypeRegistry
+{
+public:
+    // Names are never reused: replacing a prototype would leave its delta clones pointing at a deleted car
+    void add(const std::string& name, std::unique_ptr<Car> prototype)
+    {
+        if (!m_prototypes.try_emplace(name, std::move(prototype)).second) {
+            throw std::invalid_argument("Duplicate prototype: " + name);
+        }
+    }
+
+    std::unique_ptr<DeltaCar> clone(const std::string& name) const
+    {
+        auto found = m_prototypes.find(name);
+        if (found == m_prototypes.end()) {
+            throw std::invalid_argument("Unknown prototype: " + name);
+        }
+        return std::make_unique<DeltaCar>(found->second.get());
+    }
+
+private:
+    std::map<std::string, std::unique_ptr<Car>> m_prototypes;
+};
+
+// Resident set size in kilobytes (Linux only, 0 elsewhere)
+long residentKb()
+{
+    std::ifstream status("/proc/self/status");
+    std::string key;
+    while (status >> key) {
+        if (key == "VmRSS:") {
+            long kb = 0;
+            status >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+// 95% of the clones only get a new mileage, the rest also get a new color and VIN
+template <typename Clone>
+std::vector<std::unique_ptr<Car>> buildFleet(const char* label, size_t count, Clone clone)
+{
+    std::vector<std::unique_ptr<Car>> fleet;
+    fleet.reserve(count);
+    long before = residentKb();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        std::unique_ptr<Car> car = clone();
+        car->setMileage(static_cast<int>(i % 200000));
+        if (i % 20 == 0) {
+            car->setColor("Celestial Silver Metallic");
+            car->setVIN("4T1B21HK5MU" + std::to_string(100000 + i % 900000));
+        }
+        fleet.push_back(std::move(car));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    long used = residentKb() - before;
+    std::cout << "  " << label << used * 1024.0 / count << " bytes/clone resident, "
+              << elapsed.count() * 1e9 / count << " ns/clone" << std::endl;
+    return fleet;
+}
+
+int main()
+{
+    PrototypeRegistry registry;
+
+    // Create a prototype Sedan object
+    auto sedanPrototype = std::make_unique<Sedan>();
+    sedanPrototype->setBrand("Toyota");
+    sedanPrototype->setModel("Camry Hybrid XLE");
+    sedanPrototype->setYear(2021);
+    sedanPrototype->setMileage(0);
+    sedanPrototype->setColor("Midnight Black Metallic");
+    sedanPrototype->setVIN("4T1B21HK5MU012345");
+    Sedan* prototype = sedanPrototype.get();
+    registry.add("camry", std::move(sedanPrototype));
+
+    // Clone the prototype and customize the clone: only mileage and color are stored in the clone
+    std::unique_ptr<DeltaCar> myCar = registry.clone("camry");
+    myCar->setMileage(1000);
+    myCar->setColor("Red");
+
+    std::cout << "Prototype Sedan:" << std::endl;
+    prototype->print();
+    std::cout << "Customized Sedan:" << std::endl;
+    myCar->print();
+
+    // A clone that changed almost everything gains nothing from its parent
+    myCar->setBrand("Lexus");
+    myCar->setModel("ES 300h");
+    myCar->setVIN("JTHB21B10M2012345");
+    if (myCar->overrideCount() > 4) {
+        std::unique_ptr<Sedan> standalone = myCar->flatten();
+        std::cout << "Flattened Sedan:" << std::endl;
+        standalone->print();
+    }
+
+    const size_t count = 2000000;
+    std::cout << "\n" << count << " clones, 95% identical to the prototype" << std::endl;
+    auto deltas = buildFleet("delta clones : ", count, [&] { return registry.clone("camry"); });
+    auto copies = buildFleet("full clones  : ", count, [&] { return prototype->clone(); });
+
+    return 0;
+}
@@ -0,0 +1,411 @@
+/* https://github.com/mr-mousavi/design-pattern */
+
+// Bulk conversion for the socket adapter of Adapter_2.cpp.
+//
+// The Adapter of Adapter_2.cpp always reports 110 V. A recorded power trace
+// needs every sample scaled instead: ScalingAdapter does that one reading at a
+// time through virtual voltage() / live() / neutral() calls, which for millions
+// of samples is millions of virtual calls. Here the trace is kept as plain
+// arrays and converted in one go:
+//
+//   ScalingAdapter::convert() European samples -> USA samples (volts * 110 / 230)
+//   ElectricKettle::boil()    counts the samples that would make coffee / set it on fire
+//
+// Like the single-sample adapter, convert() only rewrites the voltage: the USA
+// side shares the live / neutral arrays of the European trace instead of copying.
+//
+// Both run a SIMD kernel picked once at runtime from the CPU (AVX2, then SSE2),
+// with a scalar fallback for every other CPU. The kernels give exactly the same
+// result as the scalar code for voltages in [-65535, 65535].
+//
+// Build: g++ -std=c++17 -O2 Adapter_Bulk_Voltage.cpp
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_KERNELS 1
+#endif
+
+using namespace std;
+
+
+typedef int Cable;
+
+
+class EuropeanSocketInterface
+{
+public:
+	virtual int voltage() = 0;
+
+	virtual Cable live() = 0;
+	virtual Cable neutral() = 0;
+	virtual Cable earth() = 0;
+};
+
+
+class USASocketInterface
+{
+public:
+	virtual int voltage() = 0;
+
+	virtual Cable live() = 0;
+	virtual Cable neutral() = 0;
+};
+
+
+// A recorded trace: sample i is (voltage[i], live[i], neutral[i])
+struct PowerTrace
+{
+	vector<int> voltage;
+	vector<Cable> live;
+	vector<Cable> neutral;
+
+	explicit PowerTrace(size_t count = 0) : voltage(count), live(count), neutral(count) {}
+	size_t size() const { return voltage.size(); }
+};
+
+
+// Non-owning view of a trace, so both sides of the adapter can share arrays
+struct TraceView
+{
+	const int* voltage;
+	const Cable* live;
+	const Cable* neutral;
+	size_t count;
+
+	TraceView(const PowerTrace& trace)
+		: voltage(trace.voltage.data()), live(trace.live.data()), neutral(trace.neutral.data()), count(trace.size()) {}
+	TraceView(const int* volts, const Cable* l, const Cable* n, size_t size)
+		: voltage(volts), live(l), neutral(n), count(size) {}
+};
+
+
+// Plays a European trace back one sample at a time, through the classic interface
+class RecordedSocket : public EuropeanSocketInterface
+{
+	const PowerTrace* trace;
+	size_t index = 0;
+
+public:
+	explicit RecordedSocket(const PowerTrace* recording) : trace(recording) {}
+
+	void seek(size_t sample) { index = sample; }
+
+	int voltage() { return trace->voltage[index]; }
+
+	Cable live() { return trace->live[index]; }
+	Cable neutral() { return trace->neutral[index]; }
+	Cable earth() { return 0; }
+};
+
+
+// ---------------------------------------------------------------------------
+// Kernels
+// ---------------------------------------------------------------------------
+
+struct BoilReport
+{
+	size_t coffee = 0;   // samples at <= 110 V with live / neutral wired correctly
+	size_t fire = 0;     // samples above 110 V
+};
+
+namespace kernels
+{
+	void convertScalar(const int* european, int* usa, size_t count)
+	{
+		for (size_t i = 0; i < count; ++i)
+			usa[i] = european[i] * 110 / 230;
+	}
+
+	BoilReport boilScalar(const int* voltage, const Cable* live, const Cable* neutral, size_t count)
+	{
+		BoilReport report;
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (voltage[i] > 110)
+				++report.fire;
+			else if (live[i] == 1 && neutral[i] == -1)
+				++report.coffee;
+		}
+		return report;
+	}
+
+#ifdef HAVE_X86_KERNELS
+	// v * 110 is exact in float for |v| <= 65535, and the quotient is never close enough
+	// to an integer for the rounding of the division to cross it, so truncating matches
+	// the integer division
+	__attribute__((target("sse2")))
+	void convertSse2(const int* european, int* usa, size_t count)
+	{
+		const __m128 factor = _mm_set1_ps(110.0f);
+		const __m128 divisor = _mm_set1_ps(230.0f);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 volts = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(european + i)));
+			__m128i out = _mm_cvttps_epi32(_mm_div_ps(_mm_mul_ps(volts, factor), divisor));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(usa + i), out);
+		}
+		convertScalar(european + i, usa + i, count - i);
+	}
+
+	__attribute__((target("sse2")))
+	BoilReport boilSse2(const int* voltage, const Cable* live, const Cable* neutral, size_t count)
+	{
+		const __m128i limit = _mm_set1_epi32(110);
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i minusOne = _mm_set1_epi32(-1);
+		BoilReport report;
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128i volts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(voltage + i));
+			__m128i hot = _mm_cmpgt_epi32(volts, limit);
+			__m128i wired = _mm_and_si128(
+				_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(live + i)), one),
+				_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(neutral + i)), minusOne));
+			report.fire += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(hot)));
+			report.coffee += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(hot, wired))));
+		}
+		BoilReport tail = boilScalar(voltage + i, live + i, neutral + i, count - i);
+		report.fire += tail.fire;
+		report.coffee += tail.coffee;
+		return report;
+	}
+
+	__attribute__((target("avx2")))
+	void convertAvx2(const int* european, int* usa, size_t count)
+	{
+		const __m256 factor = _mm256_set1_ps(110.0f);
+		const __m256 divisor = _mm256_set1_ps(230.0f);
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 volts = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(european + i)));
+			__m256i out = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_mul_ps(volts, factor), divisor));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(usa + i), out);
+		}
+		convertScalar(european + i, usa + i, count - i);
+	}
+
+	__attribute__((target("avx2")))
+	BoilReport boilAvx2(const int* voltage, const Cable* live, const Cable* neutral, size_t count)
+	{
+		const __m256i limit = _mm256_set1_epi32(110);
+		const __m256i one = _mm256_set1_epi32(1);
+		const __m256i minusOne = _mm256_set1_epi32(-1);
+		BoilReport report;
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256i volts = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(voltage + i));
+			__m256i hot = _mm256_cmpgt_epi32(volts, limit);
+			__m256i wired = _mm256_and_si256(
+				_mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(live + i)), one),
+				_mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(neutral + i)), minusOne));
+			report.fire += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(hot)));
+			report.coffee += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(hot, wired))));
+		}
+		BoilReport tail = boilScalar(voltage + i, live + i, neutral + i, count - i);
+		report.fire += tail.fire;
+		report.coffee += tail.coffee;
+		return report;
+	}
+#endif
+
+	typedef void (*ConvertKernel)(const int*, int*, size_t);
+	typedef BoilReport (*BoilKernel)(const int*, const Cable*, const Cable*, size_t);
+
+	struct Dispatch
+	{
+		ConvertKernel convert;
+		BoilKernel boil;
+		const char* name;
+	};
+
+	// Chosen once, on first use
+	const Dispatch& best()
+	{
+		static const Dispatch dispatch = []() -> Dispatch
+		{
+#ifdef HAVE_X86_KERNELS
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return { convertAvx2, boilAvx2, "AVX2" };
+			if (__builtin_cpu_supports("sse2"))
+				return { convertSse2, boilSse2, "SSE2" };
+#endif
+			return { convertScalar, boilScalar, "scalar" };
+		}();
+		return dispatch;
+	}
+}
+
+
+// ---------------------------------------------------------------------------
+// Adapters and kettle
+// ---------------------------------------------------------------------------
+
+class Adapter : public USASocketInterface
+{
+	EuropeanSocketInterface* socket;
+
+public:
+	void plugIn(EuropeanSocketInterface* outlet)
+	{
+		socket = outlet;
+	}
+
+	int voltage() { return 110; }
+	Cable live() { return socket->live(); }
+	Cable neutral() { return socket->neutral(); }
+};
+
+
+// Scales every reading of the socket instead of reporting a fixed 110 V
+class ScalingAdapter : public USASocketInterface
+{
+	EuropeanSocketInterface* socket;
+
+public:
+	void plugIn(EuropeanSocketInterface* outlet)
+	{
+		socket = outlet;
+	}
+
+	int voltage() { return socket->voltage() * 110 / 230; }
+	Cable live() { return socket->live(); }
+	Cable neutral() { return socket->neutral(); }
+
+	// Converts a whole European trace. usaVoltage must hold european.count samples;
+	// the returned USA view uses it for the voltage and shares live / neutral.
+	static TraceView convert(const TraceView& european, int* usaVoltage)
+	{
+		kernels::best().convert(european.voltage, usaVoltage, european.count);
+		return TraceView(usaVoltage, european.live, european.neutral, european.count);
+	}
+};
+
+
+class ElectricKettle
+{
+	USASocketInterface* power;
+
+public:
+	void plugIn(USASocketInterface* supply)
+	{
+		power = supply;
+	}
+
+	void boil()
+	{
+		if (power->voltage() > 110)
+		{
+			std::cout << "Kettle is on fire!" << std::endl;
+			return;
+		}
+
+		if (power->live() == 1 && power->neutral() == -1)
+		{
+			std::cout << "Coffee time!" << std::endl;
+		}
+	}
+
+	// The same check as boil(), over every sample of a USA-side trace
+	static BoilReport boil(const TraceView& usa)
+	{
+		return kernels::best().boil(usa.voltage, usa.live, usa.neutral, usa.count);
+	}
+};
+
+
+void benchmark(size_t count)
+{
+	// Mains hovering around 230 V, with spikes and a few miswired samples
+	PowerTrace european(count);
+	unsigned seed = 12345;
+	for (size_t i = 0; i < count; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		european.voltage[i] = 222 + static_cast<int>((seed >> 16) % 16);
+		european.live[i] = (seed >> 8) % 1000 ? 1 : 0;
+		european.neutral[i] = -1;
+	}
+
+	using Clock = chrono::steady_clock;
+
+	// One sample at a time through the virtual interfaces
+	RecordedSocket socket(&european);
+	ScalingAdapter adapter;
+	adapter.plugIn(&socket);
+	USASocketInterface* usaSide = &adapter;
+	BoilReport single;
+	auto start = Clock::now();
+	for (size_t i = 0; i < count; ++i)
+	{
+		socket.seek(i);
+		if (usaSide->voltage() > 110)
+			++single.fire;
+		else if (usaSide->live() == 1 && usaSide->neutral() == -1)
+			++single.coffee;
+	}
+	chrono::duration<double> singleTime = Clock::now() - start;
+
+	// Output buffers are allocated and touched up front: a trace pipeline reuses them
+	vector<int> scalarVoltage(count, 0);
+	vector<int> simdVoltage(count, 0);
+
+	// Scalar bulk kernels
+	start = Clock::now();
+	kernels::convertScalar(european.voltage.data(), scalarVoltage.data(), count);
+	BoilReport scalar = kernels::boilScalar(scalarVoltage.data(), european.live.data(), european.neutral.data(), count);
+	chrono::duration<double> scalarTime = Clock::now() - start;
+
+	// Dispatched SIMD kernels
+	start = Clock::now();
+	TraceView usa = ScalingAdapter::convert(european, simdVoltage.data());
+	BoilReport simd = ElectricKettle::boil(usa);
+	chrono::duration<double> simdTime = Clock::now() - start;
+
+	bool same = scalarVoltage == simdVoltage && simd.fire == scalar.fire && simd.coffee == scalar.coffee
+		&& simd.fire == single.fire && simd.coffee == single.coffee;
+
+	cout << "\n" << count << " samples converted and checked (" << simd.coffee << " coffee, " << simd.fire << " fire)" << endl;
+	cout << "  per-sample virtual calls : " << count / singleTime.count() / 1e6 << " M samples/s" << endl;
+	cout << "  bulk scalar              : " << count / scalarTime.count() / 1e6 << " M samples/s" << endl;
+	cout << "  bulk " << kernels::best().name << "                : " << count / simdTime.count() / 1e6 << " M samples/s"
+	     << (same ? "" : "  (MISMATCH)") << endl;
+}
+
+
+int main()
+{
+	PowerTrace european(3);
+	european.voltage = { 230, 240, 230 };
+	european.live = { 1, 1, 0 };
+	european.neutral = { -1, -1, -1 };
+
+	// One sample through the classic interfaces
+	RecordedSocket socket(&european);
+	Adapter adapter;
+	ElectricKettle kettle;
+
+	adapter.plugIn(&socket);
+	kettle.plugIn(&adapter);
+
+	kettle.boil();
+
+	// The whole trace at once
+	vector<int> usaVoltage(european.size());
+	BoilReport report = ElectricKettle::boil(ScalingAdapter::convert(european, usaVoltage.data()));
+	cout << "Trace: " << report.coffee << " coffee, " << report.fire << " fire (" << kernels::best().name << ")" << endl;
+
+	benchmark(16 * 1000 * 1000);
+
+	return 0;
+}
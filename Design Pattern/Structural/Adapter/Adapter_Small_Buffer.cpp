@@ -0,0 +1,245 @@
+/*
+A value-type adapter for Adapter_1.cpp.
+
+Adapter_1.cpp adapts Square to Shape with `new SquareAdapter(&square)`: one heap allocation per adapted object (which the sample
+never frees), then two virtual calls per display() (Shape::display, then Square::draw). ShapeAdapter is a type-erased value
+instead. It wraps any object that has a draw() member and exposes it as display(), and it keeps the wrapped object (or a pointer
+to it, see below) in an inline buffer, so adapting never allocates:
+
+- ShapeAdapter(obj) stores a copy of obj inside the adapter, if it fits in INLINE_SIZE bytes;
+- ShapeAdapter(std::ref(obj)) stores only a pointer and adapts the caller's object, like SquareAdapter does.
+
+display() is one indirect call through a function pointer stored in the adapter. When the adapter holds its own copy, the exact
+type is known and draw() is called without virtual dispatch. displayAll() runs display() over a contiguous range of adapters.
+
+Build: g++ -std=c++17 -O2 Adapter_Small_Buffer.cpp
+*/
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Adaptee: defines the existing interface that needs adapting
+class Square {
+public:
+    virtual void draw() {
+        std::cout << "Drawing a square." << std::endl;
+    }
+};
+
+// Another adaptee with the same draw() interface but no common base
+class Circle {
+public:
+    void draw() {
+        std::cout << "Drawing a circle." << std::endl;
+    }
+};
+
+// Target: defines the desired interface that the client uses
+class Shape {
+public:
+    virtual ~Shape() {}
+    virtual void display() = 0;
+};
+
+// Adapter: adapts the interface of the Adaptee to the Target interface
+class SquareAdapter : public Shape {
+public:
+    SquareAdapter(Square* square) : m_square(square) {}
+    void display() override {
+        m_square->draw();
+    }
+private:
+    Square* m_square;
+};
+
+// Type-erased adapter value: anything with draw() becomes something with display(), stored inline
+class ShapeAdapter {
+public:
+    static constexpr std::size_t INLINE_SIZE = 2 * sizeof(void*);
+
+    // Adapts a reference to the caller's object
+    template <typename Adaptee>
+    ShapeAdapter(std::reference_wrapper<Adaptee> adaptee)
+        : ShapeAdapter(Pointer<Adaptee>{ &adaptee.get() }) {}
+
+    // Adapts a copy of the object, kept in the inline buffer
+    template <typename Adaptee,
+              typename = std::enable_if_t<!std::is_same<std::decay_t<Adaptee>, ShapeAdapter>::value>,
+              typename = decltype(std::declval<std::decay_t<Adaptee>&>().draw())>
+    ShapeAdapter(Adaptee&& adaptee) {
+        using Stored = std::decay_t<Adaptee>;
+        static_assert(sizeof(Stored) <= INLINE_SIZE, "adaptee does not fit the inline buffer; adapt std::ref(obj) instead");
+        static_assert(alignof(Stored) <= alignof(std::max_align_t), "adaptee is over-aligned");
+        static_assert(std::is_nothrow_move_constructible<Stored>::value, "adaptee must be nothrow movable");
+        new (&m_storage) Stored(std::forward<Adaptee>(adaptee));
+        m_display = &displayStored<Stored>;
+        m_ops = &OPS<Stored>;
+    }
+
+    ShapeAdapter(const ShapeAdapter& other) : m_display(other.m_display), m_ops(other.m_ops) {
+        m_ops->copy(&m_storage, &other.m_storage);
+    }
+
+    ShapeAdapter(ShapeAdapter&& other) noexcept : m_display(other.m_display), m_ops(other.m_ops) {
+        m_ops->move(&m_storage, &other.m_storage);
+    }
+
+    ShapeAdapter& operator=(ShapeAdapter other) noexcept {
+        m_ops->destroy(&m_storage);
+        m_display = other.m_display;
+        m_ops = other.m_ops;
+        m_ops->move(&m_storage, &other.m_storage);
+        return *this;
+    }
+
+    ~ShapeAdapter() {
+        m_ops->destroy(&m_storage);
+    }
+
+    void display() {
+        m_display(&m_storage);
+    }
+
+private:
+    template <typename Adaptee>
+    struct Pointer {
+        Adaptee* adaptee;
+        void draw() { adaptee->draw(); }
+    };
+
+    // The stored type is known exactly, so draw() is called without virtual dispatch
+    template <typename Stored>
+    static void displayStored(void* self) {
+        static_cast<Stored*>(self)->Stored::draw();
+    }
+
+    struct Ops {
+        void (*copy)(void*, const void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+    };
+
+    template <typename Stored>
+    static constexpr Ops OPS = {
+        [](void* self, const void* other) { new (self) Stored(*static_cast<const Stored*>(other)); },
+        [](void* self, void* other) { new (self) Stored(std::move(*static_cast<Stored*>(other))); },
+        [](void* self) { static_cast<Stored*>(self)->~Stored(); },
+    };
+
+    std::aligned_storage_t<INLINE_SIZE, alignof(std::max_align_t)> m_storage;
+    void (*m_display)(void*); // hot path, kept out of the ops table to save a load
+    const Ops* m_ops;
+};
+
+// Runs display() over a contiguous range of adapters
+inline void displayAll(ShapeAdapter* first, std::size_t count) {
+    for (ShapeAdapter* adapter = first; adapter != first + count; ++adapter) {
+        adapter->display();
+    }
+}
+
+inline void displayAll(std::vector<ShapeAdapter>& adapters) {
+    displayAll(adapters.data(), adapters.size());
+}
+
+// Adaptee used by the benchmark: like Square, but draw() counts instead of printing
+class CountingSquare {
+public:
+    virtual void draw() { ++m_draws; }
+private:
+    long m_draws = 0;
+};
+
+class CountingSquareAdapter : public Shape {
+public:
+    CountingSquareAdapter(CountingSquare* square) : m_square(square) {}
+    void display() override {
+        m_square->draw();
+    }
+private:
+    CountingSquare* m_square;
+};
+
+void benchmark(std::size_t count) {
+    using Clock = std::chrono::steady_clock;
+    const int rounds = 20;
+    std::vector<CountingSquare> squares(count);
+
+    auto start = Clock::now();
+    std::vector<std::unique_ptr<Shape>> heapAdapters;
+    heapAdapters.reserve(count);
+    for (auto& square : squares) {
+        heapAdapters.push_back(std::make_unique<CountingSquareAdapter>(&square));
+    }
+    std::chrono::duration<double> heapBuild = Clock::now() - start;
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (auto& shape : heapAdapters) {
+            shape->display();
+        }
+    }
+    std::chrono::duration<double> heapCalls = Clock::now() - start;
+
+    start = Clock::now();
+    std::vector<ShapeAdapter> inlineAdapters;
+    inlineAdapters.reserve(count);
+    for (auto& square : squares) {
+        inlineAdapters.emplace_back(std::ref(square));
+    }
+    std::chrono::duration<double> inlineBuild = Clock::now() - start;
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        displayAll(inlineAdapters);
+    }
+    std::chrono::duration<double> inlineCalls = Clock::now() - start;
+
+    start = Clock::now();
+    std::vector<ShapeAdapter> valueAdapters;
+    valueAdapters.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        valueAdapters.emplace_back(CountingSquare());
+    }
+    std::chrono::duration<double> valueBuild = Clock::now() - start;
+
+    start = Clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        displayAll(valueAdapters);
+    }
+    std::chrono::duration<double> valueCalls = Clock::now() - start;
+
+    std::size_t calls = count * rounds;
+    std::cout << "\n" << count << " adapted squares, " << rounds << " display() rounds" << std::endl;
+    std::cout << "  SquareAdapter (heap)  : build " << heapBuild.count() * 1e9 / count << " ns/adapter, "
+              << heapCalls.count() * 1e9 / calls << " ns/call" << std::endl;
+    std::cout << "  ShapeAdapter (ref)    : build " << inlineBuild.count() * 1e9 / count << " ns/adapter, "
+              << inlineCalls.count() * 1e9 / calls << " ns/call" << std::endl;
+    std::cout << "  ShapeAdapter (value)  : build " << valueBuild.count() * 1e9 / count << " ns/adapter, "
+              << valueCalls.count() * 1e9 / calls << " ns/call" << std::endl;
+}
+
+int main() {
+    // Adaptees
+    Square square;
+    Circle circle;
+
+    // Adapters: one refers to the square, one holds its own circle; neither allocates
+    std::vector<ShapeAdapter> shapes;
+    shapes.emplace_back(std::ref(square));
+    shapes.emplace_back(circle);
+
+    // Client
+    displayAll(shapes);
+
+    benchmark(1000000);
+
+    return 0;
+}
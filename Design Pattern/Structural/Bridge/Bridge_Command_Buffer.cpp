@@ -0,0 +1,380 @@
+/*
+Batched drawing for the bridge of Bridge_2.cpp.
+
+In Bridge_2.cpp every draw() calls straight into its renderer. A scene that interleaves circles and squares on several renderers
+jumps between implementations on every shape, so no renderer ever gets to run its own code in a tight loop. Here shapes can
+record() themselves into a CommandBuffer instead:
+
+- a recorded draw is a 12-byte DrawCommand (renderer slot, primitive, position, size) appended to one contiguous array;
+- flush() groups the commands by renderer and primitive with a stable counting sort, then hands every group to its renderer in
+  one renderCircles() / renderSquares() call. Renderers can override those to process a whole batch at once; by default they
+  loop over renderCircle() / renderSquare().
+
+flush() empties the buffer and forgets its renderers, but keeps its memory, so one buffer is meant to be reused frame after
+frame, and a renderer destroyed between frames is never looked up again. Sizes are clamped to [0, 65535] when recorded.
+
+Grouping changes the order of draws across renderers and primitives, and keeps it within a group. Use it for draws whose order
+does not matter (or that a depth test sorts out later); draw() is still there for the others.
+
+Build: g++ -std=c++17 -O2 Bridge_Command_Buffer.cpp
+*/
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+// Position and size of one primitive
+struct Primitive {
+    int x, y, size;
+};
+
+// Implementor
+class Renderer {
+public:
+    virtual void renderCircle(const Primitive& circle) = 0;
+    virtual void renderSquare(const Primitive& square) = 0;
+
+    // Batched entry points used by CommandBuffer::flush()
+    virtual void renderCircles(const Primitive* circles, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            renderCircle(circles[i]);
+        }
+    }
+    virtual void renderSquares(const Primitive* squares, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            renderSquare(squares[i]);
+        }
+    }
+
+    virtual ~Renderer() {}
+};
+
+// Concrete Implementor
+class DirectXRenderer : public Renderer {
+public:
+    void renderCircle(const Primitive&) {
+        std::cout << "DirectXRenderer rendering circle" << std::endl;
+    }
+    void renderSquare(const Primitive&) {
+        std::cout << "DirectXRenderer rendering square" << std::endl;
+    }
+    void renderCircles(const Primitive*, size_t count) {
+        std::cout << "DirectXRenderer rendering " << count << " circles" << std::endl;
+    }
+    void renderSquares(const Primitive*, size_t count) {
+        std::cout << "DirectXRenderer rendering " << count << " squares" << std::endl;
+    }
+};
+
+class OpenGLRenderer : public Renderer {
+public:
+    void renderCircle(const Primitive&) {
+        std::cout << "OpenGLRenderer rendering circle" << std::endl;
+    }
+    void renderSquare(const Primitive&) {
+        std::cout << "OpenGLRenderer rendering square" << std::endl;
+    }
+};
+
+// Compact record of one draw() call
+struct DrawCommand {
+    std::uint8_t renderer;  // slot in the CommandBuffer
+    std::uint8_t primitive; // CIRCLE or SQUARE
+    std::uint16_t size;     // clamped to [0, 65535] by record()
+    std::int32_t x, y;
+};
+
+static_assert(sizeof(DrawCommand) == 12, "draw commands are meant to stay compact");
+
+class CommandBuffer {
+public:
+    enum PrimitiveKind : std::uint8_t { CIRCLE, SQUARE, PRIMITIVE_KINDS };
+
+    static constexpr size_t MAX_RENDERERS = 256;
+
+    void reserve(size_t commands) {
+        commands_.reserve(commands);
+    }
+
+    void record(Renderer* renderer, PrimitiveKind primitive, const Primitive& where) {
+        std::uint16_t size = static_cast<std::uint16_t>(std::clamp(where.size, 0, 65535));
+        commands_.push_back({ slot(renderer), primitive, size, where.x, where.y });
+    }
+
+    size_t size() const { return commands_.size(); }
+
+    // Renders everything recorded so far, one batch per (renderer, primitive), and empties the buffer and its renderer slots
+    void flush() {
+        const size_t groups = renderers_.size() * PRIMITIVE_KINDS;
+        std::vector<size_t> start(groups + 1, 0);
+        for (const DrawCommand& command : commands_) {
+            ++start[key(command) + 1];
+        }
+        for (size_t group = 0; group < groups; ++group) {
+            start[group + 1] += start[group];
+        }
+
+        sorted_.resize(commands_.size());
+        std::vector<size_t> next(start.begin(), start.end() - 1);
+        for (const DrawCommand& command : commands_) {
+            sorted_[next[key(command)]++] = { command.x, command.y, command.size };
+        }
+
+        for (size_t group = 0; group < groups; ++group) {
+            size_t count = start[group + 1] - start[group];
+            if (count == 0) {
+                continue;
+            }
+            Renderer* renderer = renderers_[group / PRIMITIVE_KINDS];
+            const Primitive* batch = sorted_.data() + start[group];
+            if (group % PRIMITIVE_KINDS == CIRCLE) {
+                renderer->renderCircles(batch, count);
+            }
+            else {
+                renderer->renderSquares(batch, count);
+            }
+        }
+        commands_.clear();
+        renderers_.clear();
+        slotCache_.fill({});
+    }
+
+private:
+    static size_t key(const DrawCommand& command) {
+        return command.renderer * PRIMITIVE_KINDS + command.primitive;
+    }
+
+    // Renderer -> slot through a small direct-mapped cache, so recording does not search on every draw
+    std::uint8_t slot(Renderer* renderer) {
+        size_t line = (reinterpret_cast<std::uintptr_t>(renderer) >> 4) % SLOT_CACHE;
+        if (slotCache_[line].renderer == renderer) {
+            return slotCache_[line].slot;
+        }
+        auto found = std::find(renderers_.begin(), renderers_.end(), renderer);
+        if (found == renderers_.end()) {
+            if (renderers_.size() == MAX_RENDERERS) {
+                throw std::length_error("CommandBuffer: too many renderers");
+            }
+            found = renderers_.insert(renderers_.end(), renderer);
+        }
+        slotCache_[line] = { renderer, static_cast<std::uint8_t>(found - renderers_.begin()) };
+        return slotCache_[line].slot;
+    }
+
+    static constexpr size_t SLOT_CACHE = 64;
+
+    struct CachedSlot {
+        Renderer* renderer = nullptr;
+        std::uint8_t slot = 0;
+    };
+
+    std::vector<DrawCommand> commands_;
+    std::vector<Primitive> sorted_;
+    std::vector<Renderer*> renderers_;
+    std::array<CachedSlot, SLOT_CACHE> slotCache_{};
+};
+
+// Abstraction
+class Shape {
+public:
+    Shape() {}
+    virtual void draw() = 0;
+    virtual void record(CommandBuffer& buffer) = 0;
+    virtual ~Shape() {}
+};
+
+// Refined Abstraction
+class CircleShape : public Shape {
+public:
+    CircleShape(std::shared_ptr<Renderer> renderer, Primitive where) : renderer_(renderer), where_(where) {}
+    void draw() {
+        renderer_->renderCircle(where_);
+    }
+    void record(CommandBuffer& buffer) {
+        buffer.record(renderer_.get(), CommandBuffer::CIRCLE, where_);
+    }
+private:
+    std::shared_ptr<Renderer> renderer_;
+    Primitive where_;
+};
+
+class SquareShape : public Shape {
+public:
+    SquareShape(std::shared_ptr<Renderer> renderer, Primitive where) : renderer_(renderer), where_(where) {}
+    void draw() {
+        renderer_->renderSquare(where_);
+    }
+    void record(CommandBuffer& buffer) {
+        buffer.record(renderer_.get(), CommandBuffer::SQUARE, where_);
+    }
+private:
+    std::shared_ptr<Renderer> renderer_;
+    Primitive where_;
+};
+
+// Benchmark renderers. Like a GPU driver, a renderer has to bind its pipeline state for a primitive (here: copy 1 KB of
+// constants into a context shared by all renderers) before drawing, whenever another renderer or primitive was used last.
+// Instead of drawing, each one accumulates a coverage estimate of what it was asked to draw.
+struct RenderContext {
+    const void* boundRenderer = nullptr;
+    int boundPrimitive = -1;
+    std::uint64_t binds = 0;
+    std::array<std::uint32_t, 256> constants{};
+};
+
+class CoverageRenderer : public Renderer {
+public:
+    CoverageRenderer(RenderContext& context, std::uint32_t seed) : context_(context) {
+        for (size_t i = 0; i < 256; ++i) {
+            pipelines_[CommandBuffer::CIRCLE][i] = seed + static_cast<std::uint32_t>(i);
+            pipelines_[CommandBuffer::SQUARE][i] = seed * 3 + static_cast<std::uint32_t>(i);
+        }
+    }
+
+    void renderCircle(const Primitive& circle) {
+        bind(CommandBuffer::CIRCLE);
+        covered_ += circleArea(circle);
+    }
+    void renderSquare(const Primitive& square) {
+        bind(CommandBuffer::SQUARE);
+        covered_ += squareArea(square);
+    }
+    void renderCircles(const Primitive* circles, size_t count) {
+        bind(CommandBuffer::CIRCLE);
+        std::uint64_t covered = 0;
+        for (size_t i = 0; i < count; ++i) {
+            covered += circleArea(circles[i]);
+        }
+        covered_ += covered;
+    }
+    void renderSquares(const Primitive* squares, size_t count) {
+        bind(CommandBuffer::SQUARE);
+        std::uint64_t covered = 0;
+        for (size_t i = 0; i < count; ++i) {
+            covered += squareArea(squares[i]);
+        }
+        covered_ += covered;
+    }
+
+    std::uint64_t covered() const { return covered_; }
+
+private:
+    static std::uint64_t circleArea(const Primitive& circle) {
+        return 355 * static_cast<std::uint64_t>(circle.size) * circle.size / 113; // ~ pi r^2
+    }
+    static std::uint64_t squareArea(const Primitive& square) {
+        return static_cast<std::uint64_t>(square.size) * square.size;
+    }
+
+    void bind(int primitive) {
+        if (context_.boundRenderer != this || context_.boundPrimitive != primitive) {
+            context_.constants = pipelines_[primitive];
+            context_.boundRenderer = this;
+            context_.boundPrimitive = primitive;
+            ++context_.binds;
+        }
+    }
+
+    RenderContext& context_;
+    std::array<std::array<std::uint32_t, 256>, 2> pipelines_;
+    std::uint64_t covered_ = 0;
+};
+
+void benchmark(size_t count) {
+    RenderContext context;
+    std::array<std::shared_ptr<CoverageRenderer>, 4> renderers = {
+        std::make_shared<CoverageRenderer>(context, 1), std::make_shared<CoverageRenderer>(context, 2),
+        std::make_shared<CoverageRenderer>(context, 3), std::make_shared<CoverageRenderer>(context, 4),
+    };
+
+    std::vector<std::unique_ptr<Shape>> scene;
+    scene.reserve(count);
+    unsigned seed = 7;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        Primitive where = { static_cast<int>(seed >> 20), static_cast<int>((seed >> 8) & 0xfff), 1 + static_cast<int>(seed % 64) };
+        const std::shared_ptr<CoverageRenderer>& renderer = renderers[(seed >> 4) % renderers.size()];
+        if ((seed >> 12) & 1) {
+            scene.push_back(std::make_unique<CircleShape>(renderer, where));
+        }
+        else {
+            scene.push_back(std::make_unique<SquareShape>(renderer, where));
+        }
+    }
+
+    auto total = [&renderers] {
+        std::uint64_t covered = 0;
+        for (auto& renderer : renderers) {
+            covered += renderer->covered();
+        }
+        return covered;
+    };
+
+    // Renders the scene `frames` times after one warm-up frame; returns draws/s, coverage and binds of one frame
+    struct FrameStats {
+        double drawsPerSecond;
+        std::uint64_t covered;
+        std::uint64_t binds;
+    };
+    const int frames = 5;
+    auto measure = [&](auto&& renderFrame) {
+        renderFrame();
+        std::uint64_t covered = total();
+        std::uint64_t binds = context.binds;
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            renderFrame();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return FrameStats{ count * frames / elapsed.count() / 1e6, (total() - covered) / frames, (context.binds - binds) / frames };
+    };
+
+    FrameStats immediate = measure([&] {
+        for (auto& shape : scene) {
+            shape->draw();
+        }
+    });
+
+    CommandBuffer buffer;
+    buffer.reserve(count);
+    FrameStats batched = measure([&] {
+        for (auto& shape : scene) {
+            shape->record(buffer);
+        }
+        buffer.flush();
+    });
+
+    std::cout << "\n" << count << " mixed circles and squares on " << renderers.size() << " renderers, per frame" << std::endl;
+    std::cout << "  immediate draw()   : " << immediate.drawsPerSecond << " M draws/s, " << immediate.binds << " pipeline binds" << std::endl;
+    std::cout << "  record() + flush() : " << batched.drawsPerSecond << " M draws/s, " << batched.binds << " pipeline binds"
+              << (batched.covered == immediate.covered ? "" : "  (MISMATCH)") << std::endl;
+}
+
+int main() {
+    std::shared_ptr<DirectXRenderer> dxRenderer = std::make_shared<DirectXRenderer>();
+    std::shared_ptr<OpenGLRenderer> glRenderer = std::make_shared<OpenGLRenderer>();
+
+    CircleShape circle(dxRenderer, { 10, 10, 5 });
+    circle.draw(); // Output: DirectXRenderer rendering circle
+
+    SquareShape square(glRenderer, { 20, 20, 8 });
+    square.draw(); // Output: OpenGLRenderer rendering square
+
+    // Recorded draws are grouped by renderer and primitive when flushed
+    CommandBuffer buffer;
+    CircleShape circle2(dxRenderer, { 30, 30, 5 });
+    SquareShape square2(dxRenderer, { 40, 40, 8 });
+    circle.record(buffer);
+    square.record(buffer);
+    square2.record(buffer);
+    circle2.record(buffer);
+    buffer.flush(); // Output: DirectXRenderer rendering 2 circles, DirectXRenderer rendering 1 squares, OpenGLRenderer rendering square
+
+    benchmark(1000000);
+
+    return 0;
+}
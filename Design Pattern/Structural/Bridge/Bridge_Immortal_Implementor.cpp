@@ -0,0 +1,222 @@
+/*
+Shared implementors without shared reference counts, for the bridges of Bridge_1.cpp and Bridge_2.cpp.
+
+Both bridges hold their implementor in a std::shared_ptr. Copying one into a new shape and destroying the shape increment and
+decrement one atomic counter, the same one for every shape of that Renderer (or Color). When shapes are created and destroyed
+on many threads at once, that counter's cache line bounces from core to core and the threads serialize on it.
+
+Implementors are few and usually live as long as the program, so here they are owned by an ImplementorRegistry instead:
+
+- registry.make<T>(args...) creates an implementor that stays alive until the registry is destroyed;
+- it returns an Implementor<T>, a plain pointer-sized handle. Copying or dropping a handle touches no shared memory;
+- shapes hold an Implementor<Renderer> (or Implementor<Color>) where they held a shared_ptr.
+
+The registry has to outlive every shape that uses its implementors; a function-level static (or main()) is the usual place.
+The benchmark creates and destroys shapes on 1..N threads with both kinds of handles.
+
+Build: g++ -std=c++17 -O2 -pthread Bridge_Immortal_Implementor.cpp
+*/
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Non-owning handle to an implementor owned by an ImplementorRegistry
+template <typename T>
+class Implementor {
+public:
+    template <typename U>
+    Implementor(Implementor<U> other) : impl_(other.get()) {}
+
+    T* operator->() const { return impl_; }
+    T& operator*() const { return *impl_; }
+    T* get() const { return impl_; }
+
+private:
+    friend class ImplementorRegistry;
+    explicit Implementor(T* impl) : impl_(impl) {}
+
+    T* impl_;
+};
+
+// Owns implementors for the lifetime of the registry
+class ImplementorRegistry {
+public:
+    template <typename T, typename... Args>
+    Implementor<T> make(Args&&... args) {
+        auto impl = std::make_unique<T>(std::forward<Args>(args)...);
+        Implementor<T> handle(impl.get());
+        std::lock_guard<std::mutex> lock(mutex_);
+        owned_.push_back(std::unique_ptr<void, void (*)(void*)>(impl.release(), [](void* p) { delete static_cast<T*>(p); }));
+        return handle;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::unique_ptr<void, void (*)(void*)>> owned_;
+};
+
+// Implementor interface (Bridge_1.cpp)
+class Color {
+public:
+    virtual std::string getColor() = 0;
+    virtual ~Color() {}
+};
+
+class RedColor : public Color {
+public:
+    std::string getColor() override {
+        return "Red";
+    }
+};
+
+// Implementor (Bridge_2.cpp)
+class Renderer {
+public:
+    virtual void renderCircle() = 0;
+    virtual void renderSquare() = 0;
+    virtual ~Renderer() {}
+};
+
+// Concrete Implementor
+class DirectXRenderer : public Renderer {
+public:
+    void renderCircle() {
+        std::cout << "DirectXRenderer rendering circle" << std::endl;
+    }
+    void renderSquare() {
+        std::cout << "DirectXRenderer rendering square" << std::endl;
+    }
+};
+
+class OpenGLRenderer : public Renderer {
+public:
+    void renderCircle() {
+        std::cout << "OpenGLRenderer rendering circle" << std::endl;
+    }
+    void renderSquare() {
+        std::cout << "OpenGLRenderer rendering square" << std::endl;
+    }
+};
+
+// Abstraction
+class Shape {
+public:
+    Shape() {}
+    virtual void draw() = 0;
+    virtual ~Shape() {}
+};
+
+// Refined Abstraction, parameterized on how it holds its renderer
+template <typename RendererHandle>
+class CircleShape : public Shape {
+public:
+    CircleShape(RendererHandle renderer) : renderer_(std::move(renderer)) {}
+    void draw() {
+        renderer_->renderCircle();
+    }
+private:
+    RendererHandle renderer_;
+};
+
+template <typename RendererHandle>
+class SquareShape : public Shape {
+public:
+    SquareShape(RendererHandle renderer) : renderer_(std::move(renderer)) {}
+    void draw() {
+        renderer_->renderSquare();
+    }
+private:
+    RendererHandle renderer_;
+};
+
+// A Bridge_1.cpp shape on a registry-owned color
+class Triangle {
+public:
+    Triangle(Implementor<Color> color) : color_(color) {}
+    std::string getShape() {
+        return color_->getColor() + " Triangle";
+    }
+private:
+    Implementor<Color> color_;
+};
+
+// Renderer used by the benchmark: draws nothing, so only handle traffic is measured
+class NullRenderer : public Renderer {
+public:
+    void renderCircle() {}
+    void renderSquare() {}
+};
+
+// Every thread creates, draws and destroys `perThread` shapes sharing one renderer
+template <typename RendererHandle>
+double shapesPerSecond(const RendererHandle& renderer, unsigned threads, size_t perThread) {
+    auto work = [&renderer, perThread] {
+        const size_t batch = 16;
+        for (size_t done = 0; done < perThread; done += batch) {
+            std::vector<CircleShape<RendererHandle>> shapes;
+            shapes.reserve(batch);
+            for (size_t i = 0; i < batch; ++i) {
+                shapes.emplace_back(renderer);
+            }
+            for (auto& shape : shapes) {
+                shape.draw();
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(work);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return threads * perThread / elapsed.count() / 1e6;
+}
+
+void benchmark(ImplementorRegistry& registry, size_t perThread) {
+    std::shared_ptr<Renderer> shared = std::make_shared<NullRenderer>();
+    Implementor<Renderer> immortal = registry.make<NullRenderer>();
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "\nCreate + draw + destroy, " << perThread << " shapes per thread, one shared renderer" << std::endl;
+    std::vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < cores; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(cores);
+
+    for (unsigned threads : threadCounts) {
+        std::cout << "  " << threads << " thread(s): shared_ptr " << shapesPerSecond(shared, threads, perThread)
+                  << " M shapes/s, Implementor " << shapesPerSecond(immortal, threads, perThread) << " M shapes/s" << std::endl;
+    }
+}
+
+int main() {
+    ImplementorRegistry registry;
+
+    Implementor<Renderer> dxRenderer = registry.make<DirectXRenderer>();
+    Implementor<Renderer> glRenderer = registry.make<OpenGLRenderer>();
+
+    CircleShape<Implementor<Renderer>> circle(dxRenderer);
+    circle.draw(); // Output: DirectXRenderer rendering circle
+
+    SquareShape<Implementor<Renderer>> square(glRenderer);
+    square.draw(); // Output: OpenGLRenderer rendering square
+
+    Triangle triangle(registry.make<RedColor>());
+    std::cout << triangle.getShape() << std::endl; // Output: Red Triangle
+
+    benchmark(registry, 20000000);
+
+    return 0;
+}
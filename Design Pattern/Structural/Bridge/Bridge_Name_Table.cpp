@@ -0,0 +1,325 @@
+/*
+Precomputed shape names for the Color / Shape bridge of Bridge_1.cpp.
+
+In Bridge_1.cpp every getShape() call makes two virtual calls and concatenates two freshly built strings
+(color_->getColor() + " " + getName()). The set of possible results is small and fixed: one per (color, shape) pair. Here both
+hierarchies register into a NameTable instead:
+
+- every Color and every Shape class has a small integer id;
+- the names of the built-in pairs (Red/Green/Blue x Triangle/Square/Circle) are composed at compile time;
+- registerColor() / registerShape() add new colors and shape classes at runtime, and compose their names with everything
+  registered so far. Registering a name that is already known returns its id, so the table only grows with distinct names.
+
+A shape looks its name up once, when it is constructed, and getShape() returns it as a std::string_view: no virtual call, no
+allocation. Names live as long as the program, so the views stay valid even after the shape or the color is gone.
+
+Build: g++ -std=c++17 -O2 Bridge_Name_Table.cpp
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using ColorId = std::size_t;
+using ShapeId = std::size_t;
+
+namespace builtin {
+    constexpr std::size_t MAX_NAME = 16;
+
+    constexpr std::array<std::string_view, 3> COLORS = { "Red", "Green", "Blue" };
+    constexpr std::array<std::string_view, 3> SHAPES = { "Triangle", "Square", "Circle" };
+
+    constexpr ColorId RED = 0, GREEN = 1, BLUE = 2;
+    constexpr ShapeId TRIANGLE = 0, SQUARE = 1, CIRCLE = 2;
+
+    struct Name {
+        char text[MAX_NAME] = {};
+        std::size_t size = 0;
+
+        constexpr void append(std::string_view part) {
+            for (char c : part) {
+                text[size++] = c;
+            }
+        }
+        constexpr std::string_view view() const { return std::string_view(text, size); }
+    };
+
+    // "<color> <shape>" for every built-in pair, indexed [color * SHAPES.size() + shape]
+    constexpr std::array<Name, COLORS.size() * SHAPES.size()> composeNames() {
+        std::array<Name, COLORS.size() * SHAPES.size()> names{};
+        for (std::size_t color = 0; color < COLORS.size(); ++color) {
+            for (std::size_t shape = 0; shape < SHAPES.size(); ++shape) {
+                Name& name = names[color * SHAPES.size() + shape];
+                name.append(COLORS[color]);
+                name.append(" ");
+                name.append(SHAPES[shape]);
+            }
+        }
+        return names;
+    }
+
+    constexpr auto NAMES = composeNames();
+
+    static_assert(NAMES[GREEN * SHAPES.size() + TRIANGLE].view() == "Green Triangle", "built-in names are composed at compile time");
+}
+
+// Every "<color> <shape>" name, built-in or registered at runtime
+class NameTable {
+public:
+    static NameTable& instance() {
+        static NameTable table;
+        return table;
+    }
+
+    ColorId registerColor(std::string_view color) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = std::find(colors_.begin(), colors_.end(), color);
+        if (found != colors_.end()) {
+            return found - colors_.begin();
+        }
+        ColorId id = colors_.size();
+        colors_.push_back(own(color));
+        names_.emplace_back();
+        for (ShapeId shape = 0; shape < shapes_.size(); ++shape) {
+            names_[id].push_back(compose(id, shape));
+        }
+        return id;
+    }
+
+    ShapeId registerShape(std::string_view shape) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = std::find(shapes_.begin(), shapes_.end(), shape);
+        if (found != shapes_.end()) {
+            return found - shapes_.begin();
+        }
+        ShapeId id = shapes_.size();
+        shapes_.push_back(own(shape));
+        for (ColorId color = 0; color < colors_.size(); ++color) {
+            names_[color].push_back(compose(color, id));
+        }
+        return id;
+    }
+
+    // Valid for the lifetime of the program
+    std::string_view name(ColorId color, ShapeId shape) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_[color][shape];
+    }
+
+    std::string_view colorName(ColorId color) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return colors_[color];
+    }
+
+    std::string_view shapeName(ShapeId shape) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return shapes_[shape];
+    }
+
+private:
+    NameTable() : colors_(builtin::COLORS.begin(), builtin::COLORS.end()), shapes_(builtin::SHAPES.begin(), builtin::SHAPES.end()) {
+        for (ColorId color = 0; color < colors_.size(); ++color) {
+            names_.emplace_back();
+            for (ShapeId shape = 0; shape < shapes_.size(); ++shape) {
+                names_[color].push_back(builtin::NAMES[color * builtin::SHAPES.size() + shape].view());
+            }
+        }
+    }
+
+    std::string_view own(std::string_view text) {
+        storage_.emplace_back(text);
+        return storage_.back();
+    }
+
+    std::string_view compose(ColorId color, ShapeId shape) {
+        std::string name;
+        name.reserve(colors_[color].size() + 1 + shapes_[shape].size());
+        name.append(colors_[color]).append(" ").append(shapes_[shape]);
+        storage_.push_back(std::move(name));
+        return storage_.back();
+    }
+
+    mutable std::mutex mutex_;
+    std::deque<std::string> storage_; // runtime names; a deque never moves its elements
+    std::vector<std::string_view> colors_;
+    std::vector<std::string_view> shapes_;
+    std::vector<std::vector<std::string_view>> names_; // [color][shape]
+};
+
+// Implementor interface
+class Color {
+public:
+    explicit Color(ColorId id) : id_(id) {}
+    virtual std::string_view getColor() = 0;
+    virtual ~Color() {}
+    ColorId colorId() const { return id_; }
+private:
+    ColorId id_;
+};
+
+// Concrete Implementors
+class RedColor : public Color {
+public:
+    RedColor() : Color(builtin::RED) {}
+    std::string_view getColor() override {
+        return "Red";
+    }
+};
+
+class GreenColor : public Color {
+public:
+    GreenColor() : Color(builtin::GREEN) {}
+    std::string_view getColor() override {
+        return "Green";
+    }
+};
+
+class BlueColor : public Color {
+public:
+    BlueColor() : Color(builtin::BLUE) {}
+    std::string_view getColor() override {
+        return "Blue";
+    }
+};
+
+// A color added at runtime; every CustomColor of the same name shares one id
+class CustomColor : public Color {
+public:
+    explicit CustomColor(std::string_view name) : Color(NameTable::instance().registerColor(name)) {}
+    std::string_view getColor() override {
+        return NameTable::instance().colorName(colorId());
+    }
+};
+
+// Abstraction interface
+class Shape {
+public:
+    Shape(std::shared_ptr<Color> color, ShapeId shape)
+        : color_(color), name_(NameTable::instance().name(color->colorId(), shape)) {}
+    virtual std::string_view getName() = 0;
+    virtual ~Shape() {}
+
+    // "<color> <shape>", looked up once at construction
+    std::string_view getShape() const {
+        return name_;
+    }
+protected:
+    std::shared_ptr<Color> color_;
+private:
+    std::string_view name_;
+};
+
+// Refined Abstractions
+class Triangle : public Shape {
+public:
+    Triangle(std::shared_ptr<Color> color) : Shape(color, builtin::TRIANGLE) {}
+    std::string_view getName() override {
+        return "Triangle";
+    }
+};
+
+class Square : public Shape {
+public:
+    Square(std::shared_ptr<Color> color) : Shape(color, builtin::SQUARE) {}
+    std::string_view getName() override {
+        return "Square";
+    }
+};
+
+class Circle : public Shape {
+public:
+    Circle(std::shared_ptr<Color> color) : Shape(color, builtin::CIRCLE) {}
+    std::string_view getName() override {
+        return "Circle";
+    }
+};
+
+// A shape class added at runtime; it registers itself the first time one is made
+class Hexagon : public Shape {
+public:
+    Hexagon(std::shared_ptr<Color> color) : Shape(color, id()) {}
+    std::string_view getName() override {
+        return "Hexagon";
+    }
+private:
+    static ShapeId id() {
+        static const ShapeId registered = NameTable::instance().registerShape("Hexagon");
+        return registered;
+    }
+};
+
+// getShape() as Bridge_1.cpp computes it, for comparison
+std::string concatenatedShape(Color& color, Shape& shape) {
+    return std::string(color.getColor()) + " " + std::string(shape.getName());
+}
+
+void benchmark(std::size_t count) {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::shared_ptr<Color>> colors = {
+        std::make_shared<RedColor>(), std::make_shared<GreenColor>(), std::make_shared<BlueColor>(),
+        std::make_shared<CustomColor>("Ultramarine"),
+    };
+
+    std::vector<std::unique_ptr<Shape>> scene;
+    std::vector<Color*> sceneColors;
+    scene.reserve(count);
+    sceneColors.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::shared_ptr<Color>& color = colors[(i * 7) % colors.size()];
+        switch (i % 4) {
+        case 0: scene.push_back(std::make_unique<Triangle>(color)); break;
+        case 1: scene.push_back(std::make_unique<Square>(color)); break;
+        case 2: scene.push_back(std::make_unique<Circle>(color)); break;
+        default: scene.push_back(std::make_unique<Hexagon>(color)); break;
+        }
+        sceneColors.push_back(color.get());
+    }
+
+    auto start = Clock::now();
+    std::size_t concatenatedBytes = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        concatenatedBytes += concatenatedShape(*sceneColors[i], *scene[i]).size();
+    }
+    std::chrono::duration<double> concatenated = Clock::now() - start;
+
+    start = Clock::now();
+    std::size_t tableBytes = 0;
+    for (auto& shape : scene) {
+        tableBytes += shape->getShape().size();
+    }
+    std::chrono::duration<double> table = Clock::now() - start;
+
+    std::cout << "\n" << count << " shapes, getShape() over the whole scene" << std::endl;
+    std::cout << "  concatenated strings : " << concatenated.count() * 1e9 / count << " ns/shape (" << concatenatedBytes << " chars)" << std::endl;
+    std::cout << "  name table           : " << table.count() * 1e9 / count << " ns/shape (" << tableBytes << " chars)" << std::endl;
+}
+
+int main() {
+    std::shared_ptr<RedColor> red = std::make_shared<RedColor>();
+    std::shared_ptr<GreenColor> green = std::make_shared<GreenColor>();
+    std::shared_ptr<BlueColor> blue = std::make_shared<BlueColor>();
+    std::shared_ptr<CustomColor> teal = std::make_shared<CustomColor>("Teal");
+
+    std::unique_ptr<Shape> triangleRed = std::make_unique<Triangle>(red);
+    std::unique_ptr<Shape> squareGreen = std::make_unique<Square>(green);
+    std::unique_ptr<Shape> circleBlue = std::make_unique<Circle>(blue);
+    std::unique_ptr<Shape> hexagonTeal = std::make_unique<Hexagon>(teal);
+
+    std::cout << triangleRed->getShape() << std::endl; // Output: Red Triangle
+    std::cout << squareGreen->getShape() << std::endl; // Output: Green Square
+    std::cout << circleBlue->getShape()  << std::endl; // Output: Blue Circle
+    std::cout << hexagonTeal->getShape() << std::endl; // Output: Teal Hexagon
+
+    benchmark(10000000);
+
+    return 0;
+}
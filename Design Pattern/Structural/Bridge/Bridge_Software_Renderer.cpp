@@ -0,0 +1,302 @@
+/*
+A headless software renderer for the bridge of Bridge_2.cpp.
+
+DirectXRenderer and OpenGLRenderer only print what they would draw. SoftwareRenderer is a third implementor that really draws:
+it rasterizes circles and squares into an in-memory RGB framebuffer and can save it as a PPM image, so the render path can be
+checked and timed on machines without a GPU.
+
+The renderer interface now takes what to draw: renderCircle(x, y, radius, color) and renderSquare(x, y, side, color). Both
+shapes are rasterized one horizontal span per row, and every span is filled 8 (AVX2) or 4 (SSE2) pixels per store; the
+instruction set is picked once at runtime. Shapes are clipped to the framebuffer: rows outside it are never visited.
+
+The demo writes the frame to Bridge_Software_Renderer.ppm in the current directory.
+
+Build: g++ -std=c++17 -O2 Bridge_Software_Renderer.cpp
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_X86_SPANS 1
+#endif
+
+struct Rgb {
+    std::uint8_t r, g, b;
+};
+
+// Implementor
+class Renderer {
+public:
+    virtual void renderCircle(int x, int y, int radius, Rgb color) = 0;
+    virtual void renderSquare(int x, int y, int side, Rgb color) = 0;
+    virtual ~Renderer() {}
+};
+
+// Concrete Implementor
+class DirectXRenderer : public Renderer {
+public:
+    void renderCircle(int x, int y, int radius, Rgb) {
+        std::cout << "DirectXRenderer rendering circle at (" << x << ", " << y << "), radius " << radius << std::endl;
+    }
+    void renderSquare(int x, int y, int side, Rgb) {
+        std::cout << "DirectXRenderer rendering square at (" << x << ", " << y << "), side " << side << std::endl;
+    }
+};
+
+class OpenGLRenderer : public Renderer {
+public:
+    void renderCircle(int x, int y, int radius, Rgb) {
+        std::cout << "OpenGLRenderer rendering circle at (" << x << ", " << y << "), radius " << radius << std::endl;
+    }
+    void renderSquare(int x, int y, int side, Rgb) {
+        std::cout << "OpenGLRenderer rendering square at (" << x << ", " << y << "), side " << side << std::endl;
+    }
+};
+
+// Span fillers: write `count` copies of a packed pixel
+namespace spans {
+    void fillScalar(std::uint32_t* out, int count, std::uint32_t pixel) {
+        for (int i = 0; i < count; ++i) {
+            out[i] = pixel;
+        }
+    }
+
+#ifdef HAVE_X86_SPANS
+    __attribute__((target("sse2")))
+    void fillSse2(std::uint32_t* out, int count, std::uint32_t pixel) {
+        const __m128i value = _mm_set1_epi32(static_cast<int>(pixel));
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+        }
+        fillScalar(out + i, count - i, pixel);
+    }
+
+    __attribute__((target("avx2")))
+    void fillAvx2(std::uint32_t* out, int count, std::uint32_t pixel) {
+        const __m256i value = _mm256_set1_epi32(static_cast<int>(pixel));
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), value);
+        }
+        fillSse2(out + i, count - i, pixel);
+    }
+#endif
+
+    typedef void (*Fill)(std::uint32_t*, int, std::uint32_t);
+
+    struct Dispatch {
+        Fill fill;
+        const char* name;
+    };
+
+    // Chosen once, on first use
+    const Dispatch& best() {
+        static const Dispatch dispatch = []() -> Dispatch {
+#ifdef HAVE_X86_SPANS
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return { fillAvx2, "AVX2" };
+            }
+            return { fillSse2, "SSE2" };
+#else
+            return { fillScalar, "scalar" };
+#endif
+        }();
+        return dispatch;
+    }
+}
+
+// Concrete Implementor that rasterizes into memory
+class SoftwareRenderer : public Renderer {
+public:
+    SoftwareRenderer(int width, int height, spans::Fill fill = spans::best().fill)
+        : width_(width), height_(height), pixels_(static_cast<size_t>(width) * height), fill_(fill) {}
+
+    void renderCircle(int x, int y, int radius, Rgb color) {
+        std::uint32_t pixel = pack(color);
+        int top = std::max(-radius, -y);
+        int bottom = std::min(radius, height_ - 1 - y);
+        for (int dy = top; dy <= bottom; ++dy) {
+            int halfWidth = static_cast<int>(std::sqrt(static_cast<double>(radius * radius - dy * dy)));
+            span(y + dy, x - halfWidth, x + halfWidth + 1, pixel);
+        }
+    }
+
+    void renderSquare(int x, int y, int side, Rgb color) {
+        std::uint32_t pixel = pack(color);
+        int top = std::max(y, 0);
+        int bottom = std::min(y + side, height_);
+        for (int row = top; row < bottom; ++row) {
+            span(row, x, x + side, pixel);
+        }
+    }
+
+    void clear(Rgb color) {
+        fill_(pixels_.data(), static_cast<int>(pixels_.size()), pack(color));
+    }
+
+    Rgb pixel(int x, int y) const {
+        std::uint32_t value = pixels_[static_cast<size_t>(y) * width_ + x];
+        return { static_cast<std::uint8_t>(value), static_cast<std::uint8_t>(value >> 8), static_cast<std::uint8_t>(value >> 16) };
+    }
+
+    // Binary PPM (P6); returns false if the file cannot be written
+    bool writePpm(const std::string& path) const {
+        std::ofstream out(path, std::ios::binary);
+        out << "P6\n" << width_ << " " << height_ << "\n255\n";
+        std::vector<char> row(static_cast<size_t>(width_) * 3);
+        for (int y = 0; y < height_; ++y) {
+            for (int x = 0; x < width_; ++x) {
+                Rgb color = pixel(x, y);
+                row[x * 3] = static_cast<char>(color.r);
+                row[x * 3 + 1] = static_cast<char>(color.g);
+                row[x * 3 + 2] = static_cast<char>(color.b);
+            }
+            out.write(row.data(), static_cast<std::streamsize>(row.size()));
+        }
+        return static_cast<bool>(out);
+    }
+
+    // Pixels written by renderCircle() / renderSquare() since construction
+    std::uint64_t pixelsFilled() const { return filled_; }
+
+private:
+    static std::uint32_t pack(Rgb color) {
+        return color.r | (color.g << 8) | (static_cast<std::uint32_t>(color.b) << 16);
+    }
+
+    // Fills [x0, x1) of row y, clipped to the framebuffer
+    void span(int y, int x0, int x1, std::uint32_t pixel) {
+        if (y < 0 || y >= height_) {
+            return;
+        }
+        x0 = std::max(x0, 0);
+        x1 = std::min(x1, width_);
+        if (x0 >= x1) {
+            return;
+        }
+        fill_(&pixels_[static_cast<size_t>(y) * width_ + x0], x1 - x0, pixel);
+        filled_ += x1 - x0;
+    }
+
+    int width_;
+    int height_;
+    std::vector<std::uint32_t> pixels_; // 0x00BBGGRR
+    spans::Fill fill_;
+    std::uint64_t filled_ = 0;
+};
+
+// Abstraction
+class Shape {
+public:
+    Shape() {}
+    virtual void draw() = 0;
+    virtual ~Shape() {}
+};
+
+// Refined Abstraction
+class CircleShape : public Shape {
+public:
+    CircleShape(std::shared_ptr<Renderer> renderer, int x, int y, int radius, Rgb color)
+        : renderer_(renderer), x_(x), y_(y), radius_(radius), color_(color) {}
+    void draw() {
+        renderer_->renderCircle(x_, y_, radius_, color_);
+    }
+private:
+    std::shared_ptr<Renderer> renderer_;
+    int x_, y_, radius_;
+    Rgb color_;
+};
+
+class SquareShape : public Shape {
+public:
+    SquareShape(std::shared_ptr<Renderer> renderer, int x, int y, int side, Rgb color)
+        : renderer_(renderer), x_(x), y_(y), side_(side), color_(color) {}
+    void draw() {
+        renderer_->renderSquare(x_, y_, side_, color_);
+    }
+private:
+    std::shared_ptr<Renderer> renderer_;
+    int x_, y_, side_;
+    Rgb color_;
+};
+
+// Random circles and squares of 4..67 pixels across a 1920x1080 frame
+std::vector<std::unique_ptr<Shape>> makeScene(std::shared_ptr<Renderer> renderer, size_t count) {
+    std::vector<std::unique_ptr<Shape>> scene;
+    scene.reserve(count);
+    unsigned seed = 2024;
+    auto next = [&seed](unsigned range) {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<int>((seed >> 8) % range);
+    };
+    for (size_t i = 0; i < count; ++i) {
+        int x = next(1920), y = next(1080), size = 4 + next(64);
+        Rgb color = { static_cast<std::uint8_t>(next(256)), static_cast<std::uint8_t>(next(256)), static_cast<std::uint8_t>(next(256)) };
+        if (i % 2) {
+            scene.push_back(std::make_unique<CircleShape>(renderer, x, y, size / 2, color));
+        }
+        else {
+            scene.push_back(std::make_unique<SquareShape>(renderer, x, y, size, color));
+        }
+    }
+    return scene;
+}
+
+void benchmark(size_t count) {
+    std::cout << "\n" << count << " random shapes on a 1920x1080 framebuffer" << std::endl;
+
+    struct Mode {
+        const char* name;
+        spans::Fill fill;
+    };
+    for (Mode mode : { Mode{ "scalar", spans::fillScalar }, Mode{ spans::best().name, spans::best().fill } }) {
+        auto renderer = std::make_shared<SoftwareRenderer>(1920, 1080, mode.fill);
+        auto scene = makeScene(renderer, count);
+        renderer->clear({ 0, 0, 0 });
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto& shape : scene) {
+            shape->draw();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "  " << mode.name << " spans : " << renderer->pixelsFilled() / elapsed.count() / 1e6 << " M pixels/s, "
+                  << count / elapsed.count() / 1e6 << " M shapes/s" << std::endl;
+    }
+}
+
+int main() {
+    std::shared_ptr<DirectXRenderer> dxRenderer = std::make_shared<DirectXRenderer>();
+    std::shared_ptr<SoftwareRenderer> swRenderer = std::make_shared<SoftwareRenderer>(320, 240);
+
+    CircleShape circle(dxRenderer, 160, 120, 40, { 255, 0, 0 });
+    circle.draw(); // Output: DirectXRenderer rendering circle at (160, 120), radius 40
+
+    // The same shapes, drawn for real
+    swRenderer->clear({ 255, 255, 255 });
+    CircleShape redCircle(swRenderer, 160, 120, 80, { 220, 30, 30 });
+    SquareShape blueSquare(swRenderer, 20, 20, 60, { 30, 60, 200 });
+    redCircle.draw();
+    blueSquare.draw();
+
+    Rgb center = swRenderer->pixel(160, 120);
+    std::cout << "SoftwareRenderer: center pixel (" << int(center.r) << ", " << int(center.g) << ", " << int(center.b) << "), "
+              << swRenderer->pixelsFilled() << " pixels filled" << std::endl;
+    if (swRenderer->writePpm("Bridge_Software_Renderer.ppm")) {
+        std::cout << "Wrote Bridge_Software_Renderer.ppm" << std::endl;
+    }
+
+    benchmark(1000000);
+
+    return 0;
+}
@@ -0,0 +1,491 @@
+/*
+Bounding volumes for the Group tree of Composite_1.cpp.
+
+The objects of Composite_1.cpp have no position, so finding what is inside a viewport or under the mouse means visiting every
+one of them. Here every leaf has a position and an axis-aligned bounding Box, and every Group keeps the union of its children's
+boxes, which turns the Group tree itself into a bounding-volume hierarchy:
+
+- draw(viewport) and query(region, hits) skip every group whose box misses the region;
+- hitTest(x, y) returns the topmost object under the point (the last one drawn), checking the children of a group from the top
+  down and skipping groups whose box does not contain the point;
+- moving or resizing a leaf (moveTo(), setRadius(), setSide()) refits the boxes of its ancestors, and stops at the first one
+  whose box does not change. Positions and sizes are private, so a box can never go stale.
+
+Culling is only as good as the grouping: groups of objects that are close together give tight boxes. The benchmark groups a
+random 1M-object scene by position (Morton order) and compares viewport queries and hit-tests with a full traversal.
+
+Build: g++ -std=c++17 -O2 Composite_Bounding_Volumes.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct Group;
+
+// Axis-aligned bounding box; the default box is empty
+struct Box
+{
+    float minX = numeric_limits<float>::max(), minY = numeric_limits<float>::max();
+    float maxX = numeric_limits<float>::lowest(), maxY = numeric_limits<float>::lowest();
+
+    static Box around(float x, float y, float halfWidth, float halfHeight)
+    {
+        return { x - halfWidth, y - halfHeight, x + halfWidth, y + halfHeight };
+    }
+
+    bool contains(float x, float y) const
+    {
+        return x >= minX && x <= maxX && y >= minY && y <= maxY;
+    }
+    bool intersects(const Box& other) const
+    {
+        return minX <= other.maxX && other.minX <= maxX && minY <= other.maxY && other.minY <= maxY;
+    }
+    void merge(const Box& other)
+    {
+        minX = min(minX, other.minX);
+        minY = min(minY, other.minY);
+        maxX = max(maxX, other.maxX);
+        maxY = max(maxY, other.maxY);
+    }
+    bool operator==(const Box& other) const
+    {
+        return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+    }
+};
+
+// Component interface
+struct GraphicObject
+{
+    virtual void draw() = 0;
+
+    // Draws only what intersects the viewport
+    virtual void draw(const Box& viewport) = 0;
+
+    // Appends every leaf whose box intersects the region
+    virtual void query(const Box& region, vector<GraphicObject*>& hits) = 0;
+
+    // Topmost leaf that contains the point, or nullptr
+    virtual GraphicObject* hitTest(float x, float y) = 0;
+
+    const Box& bounds() const { return box; }
+
+    virtual Group* asGroup() { return nullptr; }
+
+    Group* parent = nullptr;
+
+protected:
+    // Sets this object's box and refits its ancestors
+    void setBounds(const Box& value);
+
+    // Refits the ancestors' boxes, bottom up, until one does not change
+    void refitAncestors();
+
+    Box box;
+};
+
+// Leaf class
+struct Circle : GraphicObject
+{
+    Circle(float x, float y, float radius)
+        :x_{x}, y_{y}, radius_{radius}
+    {
+        box = Box::around(x, y, radius, radius);
+    }
+
+    void draw() override
+    {
+        cout << "Circle" << endl;
+    }
+    void draw(const Box& viewport) override
+    {
+        if (box.intersects(viewport))
+            draw();
+    }
+    void query(const Box& region, vector<GraphicObject*>& hits) override
+    {
+        if (box.intersects(region))
+            hits.push_back(this);
+    }
+    GraphicObject* hitTest(float px, float py) override
+    {
+        return (px - x_) * (px - x_) + (py - y_) * (py - y_) <= radius_ * radius_ ? this : nullptr;
+    }
+
+    float x() const { return x_; }
+    float y() const { return y_; }
+    float radius() const { return radius_; }
+
+    void moveTo(float newX, float newY)
+    {
+        x_ = newX;
+        y_ = newY;
+        setBounds(Box::around(x_, y_, radius_, radius_));
+    }
+
+    void setRadius(float value)
+    {
+        radius_ = value;
+        setBounds(Box::around(x_, y_, radius_, radius_));
+    }
+
+private:
+    float x_, y_, radius_;
+};
+// Leaf class
+struct Square : GraphicObject
+{
+    // (x, y) is the center
+    Square(float x, float y, float side)
+        :x_{x}, y_{y}, side_{side}
+    {
+        box = Box::around(x, y, side / 2, side / 2);
+    }
+
+    void draw() override
+    {
+        cout << "Square" << endl;
+    }
+    void draw(const Box& viewport) override
+    {
+        if (box.intersects(viewport))
+            draw();
+    }
+    void query(const Box& region, vector<GraphicObject*>& hits) override
+    {
+        if (box.intersects(region))
+            hits.push_back(this);
+    }
+    GraphicObject* hitTest(float px, float py) override
+    {
+        return box.contains(px, py) ? this : nullptr;
+    }
+
+    float x() const { return x_; }
+    float y() const { return y_; }
+    float side() const { return side_; }
+
+    void moveTo(float newX, float newY)
+    {
+        x_ = newX;
+        y_ = newY;
+        setBounds(Box::around(x_, y_, side_ / 2, side_ / 2));
+    }
+
+    void setSide(float value)
+    {
+        side_ = value;
+        setBounds(Box::around(x_, y_, side_ / 2, side_ / 2));
+    }
+
+private:
+    float x_, y_, side_;
+};
+
+// Composite class
+struct Group :GraphicObject
+{
+    std::string name;
+    Group(const std::string& name)
+        :name{name}
+    {}
+
+    void draw() override
+    {
+        cout << "Circle" << "Objects:" << endl;
+        for (auto&& o : objects)
+            o->draw();
+    }
+
+    void draw(const Box& viewport) override
+    {
+        if (!box.intersects(viewport))
+            return;
+        cout << "Circle" << "Objects:" << endl;
+        for (auto&& o : objects)
+            o->draw(viewport);
+    }
+
+    void query(const Box& region, vector<GraphicObject*>& hits) override
+    {
+        if (!box.intersects(region))
+            return;
+        for (auto&& o : objects)
+            o->query(region, hits);
+    }
+
+    GraphicObject* hitTest(float x, float y) override
+    {
+        if (!box.contains(x, y))
+            return nullptr;
+        for (auto o = objects.rbegin(); o != objects.rend(); ++o)
+        {
+            if (GraphicObject* hit = (*o)->hitTest(x, y))
+                return hit;
+        }
+        return nullptr;
+    }
+
+    // An object belongs to one group at a time: adding it moves it out of its old group, which is refitted. Adding a group
+    // to itself or to one of its descendants throws.
+    void add(GraphicObject* object)
+    {
+        // A cycle would keep refitAncestors() going round it, and query() / hitTest() recursing
+        for (GraphicObject* node = this; node; node = node->parent)
+        {
+            if (node == object)
+                throw invalid_argument("Group: an object cannot be added below itself");
+        }
+        if (object->parent)
+            object->parent->remove(object);
+        object->parent = this;
+        objects.push_back(object);
+        Box grown = box;
+        grown.merge(object->bounds());
+        setBounds(grown);
+    }
+
+    void remove(GraphicObject* object)
+    {
+        auto found = std::find(objects.begin(), objects.end(), object);
+        if (found == objects.end())
+            return;
+        objects.erase(found);
+        object->parent = nullptr;
+        if (refit())
+            refitAncestors();
+    }
+
+    // Recomputes this group's box from its children; returns false if it did not change
+    bool refit()
+    {
+        Box fitted;
+        for (auto&& o : objects)
+            fitted.merge(o->bounds());
+        if (fitted == box)
+            return false;
+        box = fitted;
+        return true;
+    }
+
+    const std::vector<GraphicObject*>& children() const { return objects; }
+
+    Group* asGroup() override { return this; }
+
+private:
+    std::vector<GraphicObject*> objects; // private, so every change keeps the boxes up to date
+};
+
+void GraphicObject::setBounds(const Box& value)
+{
+    if (value == box)
+        return;
+    box = value;
+    refitAncestors();
+}
+
+void GraphicObject::refitAncestors()
+{
+    for (Group* group = parent; group && group->refit(); group = group->parent)
+    {
+    }
+}
+
+// Visits every leaf, without looking at group boxes: what Composite_1.cpp has to do
+template <typename Visit>
+void forEachLeaf(GraphicObject* node, Visit& visit)
+{
+    if (Group* group = node->asGroup())
+    {
+        for (auto&& o : group->children())
+            forEachLeaf(o, visit);
+    }
+    else
+    {
+        visit(node);
+    }
+}
+
+// Random circles and squares grouped by position: leaves sorted in Morton (Z) order, then groups of `fanout` up to one root
+struct Scene
+{
+    deque<Circle> circles;
+    deque<Square> squares;
+    deque<Group> groups;
+    vector<GraphicObject*> leaves;
+
+    static uint32_t spread(uint32_t v)
+    {
+        v &= 0xffff;
+        v = (v | (v << 8)) & 0x00ff00ff;
+        v = (v | (v << 4)) & 0x0f0f0f0f;
+        v = (v | (v << 2)) & 0x33333333;
+        v = (v | (v << 1)) & 0x55555555;
+        return v;
+    }
+
+    Group* build(size_t count, float worldSize, size_t fanout)
+    {
+        mt19937 random(11);
+        uniform_real_distribution<float> position(0, worldSize), size(1, 10);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i % 2)
+            {
+                circles.emplace_back(position(random), position(random), size(random) / 2);
+                leaves.push_back(&circles.back());
+            }
+            else
+            {
+                squares.emplace_back(position(random), position(random), size(random));
+                leaves.push_back(&squares.back());
+            }
+        }
+
+        vector<pair<uint32_t, GraphicObject*>> ordered;
+        for (GraphicObject* leaf : leaves)
+        {
+            const Box& b = leaf->bounds();
+            uint32_t cellX = static_cast<uint32_t>((b.minX + b.maxX) / 2 / worldSize * 65535);
+            uint32_t cellY = static_cast<uint32_t>((b.minY + b.maxY) / 2 / worldSize * 65535);
+            ordered.push_back({ spread(cellX) | (spread(cellY) << 1), leaf });
+        }
+        sort(ordered.begin(), ordered.end(), [](auto& a, auto& b) { return a.first < b.first; });
+
+        vector<GraphicObject*> level;
+        for (auto& entry : ordered)
+            level.push_back(entry.second);
+        while (level.size() > 1)
+        {
+            vector<GraphicObject*> parents;
+            for (size_t i = 0; i < level.size(); i += fanout)
+            {
+                groups.emplace_back("group " + to_string(groups.size()));
+                for (size_t j = i; j < min(i + fanout, level.size()); ++j)
+                    groups.back().add(level[j]);
+                parents.push_back(&groups.back());
+            }
+            level.swap(parents);
+        }
+        return &groups.back();
+    }
+};
+
+void benchmark(size_t count)
+{
+    using Clock = chrono::steady_clock;
+    const float world = 10000;
+    Scene scene;
+    Group* root = scene.build(count, world, 8);
+
+    mt19937 random(3);
+    uniform_real_distribution<float> anywhere(0, world);
+    cout << "\n" << count << " objects in a " << world << " x " << world << " world" << endl;
+
+    // Viewport queries
+    const int viewports = 100;
+    size_t culledHits = 0, fullHits = 0;
+    chrono::duration<double> culled(0), full(0);
+    vector<GraphicObject*> hits;
+    for (int q = 0; q < viewports; ++q)
+    {
+        Box viewport = Box::around(anywhere(random), anywhere(random), 250, 250);
+
+        auto start = Clock::now();
+        hits.clear();
+        root->query(viewport, hits);
+        culled += Clock::now() - start;
+        culledHits += hits.size();
+
+        start = Clock::now();
+        size_t inside = 0;
+        auto visit = [&](GraphicObject* leaf) { inside += leaf->bounds().intersects(viewport); };
+        forEachLeaf(root, visit);
+        full += Clock::now() - start;
+        fullHits += inside;
+    }
+    cout << "  500 x 500 viewport : BVH " << culled.count() * 1e6 / viewports << " us/query, full traversal "
+         << full.count() * 1e6 / viewports << " us/query (" << culledHits / viewports << " objects visible"
+         << (culledHits == fullHits ? "" : ", MISMATCH") << ")" << endl;
+
+    // Point hit-tests
+    const int points = 100;
+    size_t found = 0;
+    bool same = true;
+    culled = full = chrono::duration<double>(0);
+    for (int q = 0; q < points; ++q)
+    {
+        float x = anywhere(random), y = anywhere(random);
+
+        auto start = Clock::now();
+        GraphicObject* hit = root->hitTest(x, y);
+        culled += Clock::now() - start;
+
+        start = Clock::now();
+        GraphicObject* topmost = nullptr;
+        auto visit = [&](GraphicObject* leaf) {
+            if (leaf->bounds().contains(x, y) && leaf->hitTest(x, y))
+                topmost = leaf;
+        };
+        forEachLeaf(root, visit);
+        full += Clock::now() - start;
+
+        found += hit != nullptr;
+        same = same && hit == topmost;
+    }
+    cout << "  point hit-test     : BVH " << culled.count() * 1e6 / points << " us/test, full traversal "
+         << full.count() * 1e6 / points << " us/test (" << found << " of " << points << " points on an object"
+         << (same ? "" : ", MISMATCH") << ")" << endl;
+
+    // Moving 1% of the objects by a few units
+    const size_t moves = count / 100;
+    uniform_real_distribution<float> nudge(-5, 5);
+    auto start = Clock::now();
+    for (size_t m = 0; m < moves; ++m)
+    {
+        size_t i = random() % scene.leaves.size();
+        if (i % 2)
+        {
+            Circle& circle = scene.circles[i / 2];
+            circle.moveTo(circle.x() + nudge(random), circle.y() + nudge(random));
+        }
+        else
+        {
+            Square& square = scene.squares[i / 2];
+            square.moveTo(square.x() + nudge(random), square.y() + nudge(random));
+        }
+    }
+    chrono::duration<double> moving = Clock::now() - start;
+    cout << "  moveTo() with refit: " << moving.count() * 1e9 / moves << " ns/move" << endl;
+}
+
+int main()
+{
+    Group root("root");
+    Circle c1(10, 10, 5), c2(100, 100, 5);
+    root.add(&c1);
+
+    Group sub("sub");
+    sub.add(&c2);
+
+    root.add(&sub);
+
+    // Only c1 is inside the viewport, so sub is skipped as a whole
+    root.draw(Box{ 0, 0, 50, 50 });
+
+    c2.moveTo(20, 20);
+    cout << "After moving c2, hit at (20, 20): " << (root.hitTest(20, 20) == &c2 ? "c2" : "?") << endl;
+
+    benchmark(1000000);
+
+    return 0;
+}
@@ -0,0 +1,324 @@
+/*
+Cached balances for the Bank composite of Composite_2.cpp.
+
+Bank::getBalance() in Composite_2.cpp adds up the balance of every account below it on every call, so a query on a large
+account tree costs O(n). Here every Bank keeps the total of its subtree (and the number of leaf accounts in it) up to date:
+
+- a deposit into a leaf account adds the amount to the totals of every bank above it: O(depth);
+- a deposit into a bank reaches every leaf below it, as before, but the banks above it are updated once, with the whole sum;
+- addAccount() / removeAccount() add / subtract the subtree's total on the path to the root: O(depth);
+- getBalance() returns the cached total: O(1) at any node.
+
+An account belongs to at most one bank; adding it to another bank moves it. A bank cannot be added below itself, and a bank
+that is destroyed detaches its accounts and leaves its own bank. A leaf account that is destroyed leaves its bank too, so the
+totals above it drop its balance. Balances are long long, since a million accounts easily overflow an int.
+
+Build: g++ -std=c++17 -O2 Composite_Cached_Balance.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+class Bank;
+
+// Component interface
+class Account {
+public:
+    virtual ~Account() {}
+
+    void deposit(int amount);
+    virtual long long getBalance() const = 0;
+
+    // Number of leaf accounts in this subtree
+    virtual long long leafCount() const = 0;
+
+    Bank* getBank() const { return bank; }
+
+protected:
+    friend class Bank;
+    friend class SummingBank;
+
+    // Deposits into this subtree and returns the total added; the banks above are updated by deposit()
+    virtual long long depositLocal(int amount) = 0;
+
+private:
+    Bank* bank = nullptr;
+};
+
+// Leaf class
+class SavingsAccount : public Account {
+private:
+    long long balance;
+    std::ostream* log;
+public:
+    // Pass a null log for silent deposits
+    SavingsAccount(std::ostream* log = &std::cout) : balance(0), log(log) {}
+    ~SavingsAccount();
+    long long getBalance() const override {
+        return balance;
+    }
+    long long leafCount() const override {
+        return 1;
+    }
+protected:
+    long long depositLocal(int amount) override {
+        balance += amount;
+        if (log) {
+            *log << "Deposited " << amount << " into savings account." << std::endl;
+        }
+        return amount;
+    }
+};
+
+// Leaf class
+class CheckingAccount : public Account {
+private:
+    long long balance;
+    std::ostream* log;
+public:
+    // Pass a null log for silent deposits
+    CheckingAccount(std::ostream* log = &std::cout) : balance(0), log(log) {}
+    ~CheckingAccount();
+    long long getBalance() const override {
+        return balance;
+    }
+    long long leafCount() const override {
+        return 1;
+    }
+protected:
+    long long depositLocal(int amount) override {
+        balance += amount;
+        if (log) {
+            *log << "Deposited " << amount << " into checking account." << std::endl;
+        }
+        return amount;
+    }
+};
+
+// Composite class
+class Bank : public Account {
+private:
+    std::vector<Account*> accounts;
+    long long total = 0;  // sum of the balances below this bank
+    long long leaves = 0; // leaf accounts below this bank
+
+    // Adds to the cached totals of this bank and every bank above it
+    void propagate(long long amount, long long leafDelta) {
+        for (Bank* node = this; node; node = node->getBank()) {
+            node->total += amount;
+            node->leaves += leafDelta;
+        }
+    }
+
+    friend class Account;
+
+public:
+    ~Bank() {
+        for (auto account : accounts) {
+            account->bank = nullptr;
+        }
+        if (getBank()) {
+            getBank()->removeAccount(this);
+        }
+    }
+
+    void addAccount(Account* account) {
+        // A bank inside its own subtree would make propagate() loop forever
+        for (Bank* node = this; node; node = node->getBank()) {
+            if (node == account) {
+                throw std::invalid_argument("Bank: an account cannot be added below itself");
+            }
+        }
+        if (account->bank) {
+            account->bank->removeAccount(account);
+        }
+        accounts.push_back(account);
+        account->bank = this;
+        propagate(account->getBalance(), account->leafCount());
+    }
+    void removeAccount(Account* account) {
+        // Remove the account from the vector
+        auto found = std::find(accounts.begin(), accounts.end(), account);
+        if (found == accounts.end()) {
+            return;
+        }
+        accounts.erase(found);
+        account->bank = nullptr;
+        propagate(-account->getBalance(), -account->leafCount());
+    }
+    long long getBalance() const override {
+        return total;
+    }
+    long long leafCount() const override {
+        return leaves;
+    }
+protected:
+    long long depositLocal(int amount) override {
+        // Deposit into all accounts, and add their sum here once
+        long long added = 0;
+        for (auto account : accounts) {
+            added += account->depositLocal(amount);
+        }
+        total += added;
+        return added;
+    }
+};
+
+// Not in ~Account(): removeAccount() calls getBalance() and leafCount(), which must still reach the leaf
+SavingsAccount::~SavingsAccount() {
+    if (getBank()) {
+        getBank()->removeAccount(this);
+    }
+}
+
+CheckingAccount::~CheckingAccount() {
+    if (getBank()) {
+        getBank()->removeAccount(this);
+    }
+}
+
+void Account::deposit(int amount) {
+    long long added = depositLocal(amount);
+    if (bank) {
+        bank->propagate(added, 0);
+    }
+}
+
+// Bank of Composite_2.cpp, for comparison: getBalance() re-sums the whole subtree
+class SummingBank : public Account {
+private:
+    std::vector<Account*> accounts;
+public:
+    void addAccount(Account* account) {
+        accounts.push_back(account);
+    }
+    long long getBalance() const override {
+        long long totalBalance = 0;
+        // Sum the balances of all accounts
+        for (auto account : accounts) {
+            totalBalance += account->getBalance();
+        }
+        return totalBalance;
+    }
+    long long leafCount() const override {
+        long long count = 0;
+        for (auto account : accounts) {
+            count += account->leafCount();
+        }
+        return count;
+    }
+protected:
+    long long depositLocal(int amount) override {
+        long long added = 0;
+        for (auto account : accounts) {
+            added += account->depositLocal(amount);
+        }
+        return added;
+    }
+};
+
+// `count` silent leaf accounts in banks of `fanout`, banks in banks of `fanout`, up to one root bank
+template <typename BankType>
+struct AccountTree {
+    std::deque<SavingsAccount> leaves;
+    std::deque<BankType> banks;
+
+    AccountTree(size_t count, size_t fanout) {
+        std::vector<Account*> level;
+        for (size_t i = 0; i < count; ++i) {
+            leaves.emplace_back(nullptr);
+            level.push_back(&leaves.back());
+        }
+        while (level.size() > 1) {
+            std::vector<Account*> parents;
+            for (size_t i = 0; i < level.size(); i += fanout) {
+                banks.emplace_back();
+                for (size_t j = i; j < std::min(i + fanout, level.size()); ++j) {
+                    banks.back().addAccount(level[j]);
+                }
+                parents.push_back(&banks.back());
+            }
+            level.swap(parents);
+        }
+    }
+
+    BankType& root() { return banks.back(); }
+};
+
+// 80% balance queries on random banks, 10% on the root, 10% deposits into random leaves
+template <typename BankType>
+double nsPerOperation(AccountTree<BankType>& tree, size_t operations, long long& expected, long long& checksum) {
+    std::mt19937 random(5);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t op = 0; op < operations; ++op) {
+        unsigned roll = random() % 10;
+        if (roll == 0) {
+            checksum += tree.root().getBalance();
+        }
+        else if (roll == 1) {
+            tree.leaves[random() % tree.leaves.size()].deposit(10);
+            expected += 10;
+        }
+        else {
+            checksum += tree.banks[random() % tree.banks.size()].getBalance();
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() * 1e9 / operations;
+}
+
+void benchmark(size_t count) {
+    AccountTree<Bank> cached(count, 16);
+    AccountTree<SummingBank> summing(count, 16);
+
+    std::cout << "\n" << count << " accounts in banks of 16, query-heavy mix" << std::endl;
+
+    long long expected = 0, checksum = 0;
+    double cachedNs = nsPerOperation(cached, 10000000, expected, checksum);
+    bool correct = cached.root().getBalance() == expected;
+
+    long long summingExpected = 0, summingChecksum = 0;
+    double summingNs = nsPerOperation(summing, 20000, summingExpected, summingChecksum);
+
+    std::cout << "  cached totals   : " << cachedNs << " ns/operation" << (correct ? "" : "  (MISMATCH)") << std::endl;
+    std::cout << "  re-summed totals: " << summingNs << " ns/operation" << std::endl;
+}
+
+// Client code
+int main() {
+    // Create some accounts (leaf objects)
+    SavingsAccount savingsAccount;
+    CheckingAccount checkingAccount;
+
+    // Create a bank (composite object)
+    Bank bank;
+    bank.addAccount(&savingsAccount);
+    bank.addAccount(&checkingAccount);
+
+    // Deposit into the bank account (which will deposit into all accounts)
+    bank.deposit(1000);
+
+    // A bank of banks: a deposit into a leaf updates every total above it
+    Bank head;
+    head.addAccount(&bank);
+    checkingAccount.deposit(250);
+
+    // Print the total balance of all accounts
+    std::cout << "Total balance: " << bank.getBalance() << ", head office: " << head.getBalance() << std::endl;
+
+    try {
+        bank.addAccount(&head);
+    }
+    catch (const std::invalid_argument& error) {
+        std::cout << error.what() << std::endl;
+    }
+
+    benchmark(1000000);
+
+    return 0;
+}
@@ -0,0 +1,327 @@
+/*
+Incremental redraw for the Group tree of Composite_1.cpp.
+
+Group::draw() redraws every descendant on every call, even when nothing changed since the last frame. Here every node caches the
+Drawing it produced last time and carries a dirty flag:
+
+- changing a leaf (setRadius(), setSide()) or the children of a group (add(), remove()) marks that node and its ancestors dirty.
+  The walk up stops at the first ancestor that is already dirty, since its own ancestors are then dirty too;
+- drawIncremental() returns the cached Drawing of a clean node right away, and redraws a dirty one: a dirty leaf draws itself
+  again, a dirty group calls drawIncremental() on its children and combines their (mostly cached) drawings.
+
+A frame that changes k leaves thus redraws O(k * depth) nodes and looks at their siblings, instead of the whole tree. render()
+still redraws everything, for comparison.
+
+Build: g++ -std=c++17 -O2 Composite_Dirty_Tracking.cpp
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct Group;
+
+// What a subtree puts on the canvas
+struct Drawing
+{
+    double ink = 0;        // shaded coverage of every primitive
+    size_t primitives = 0;
+
+    Drawing& operator+=(const Drawing& other)
+    {
+        ink += other.ink;
+        primitives += other.primitives;
+        return *this;
+    }
+};
+
+// Component interface
+struct GraphicObject
+{
+    virtual void draw() = 0;
+
+    // Draws the whole subtree again, ignoring every cache
+    virtual Drawing render() = 0;
+
+    // Reuses the cached drawing of clean subtrees, redraws the dirty ones
+    Drawing drawIncremental()
+    {
+        if (dirty)
+        {
+            cached = redraw();
+            dirty = false;
+        }
+        return cached;
+    }
+
+    // Marks this node and its ancestors as needing a redraw
+    void markDirty()
+    {
+        for (GraphicObject* node = this; node && !node->dirty; node = node->parent)
+            node->dirty = true;
+    }
+
+    bool isDirty() const { return dirty; }
+
+    GraphicObject* parent = nullptr; // always a Group: only Group::add() sets it
+
+protected:
+    // Redraws this node; a group asks its children for their drawIncremental()
+    virtual Drawing redraw() = 0;
+
+private:
+    bool dirty = true;
+    Drawing cached;
+};
+
+// Cost of shading one primitive of the given area
+double shade(double area)
+{
+    double ink = 0;
+    for (int i = 1; i <= 64; ++i)
+        ink += sqrt(area * i);
+    return ink;
+}
+
+// Leaf class
+struct Circle : GraphicObject
+{
+    Circle(double radius = 1)
+        :radius{radius}
+    {}
+
+    void draw() override
+    {
+        cout << "Circle" << endl;
+    }
+    Drawing render() override
+    {
+        return { shade(3.14159265358979 * radius * radius), 1 };
+    }
+
+    double getRadius() const { return radius; }
+    void setRadius(double value)
+    {
+        radius = value;
+        markDirty();
+    }
+
+protected:
+    Drawing redraw() override { return render(); }
+
+private:
+    double radius;
+};
+// Leaf class
+struct Square : GraphicObject
+{
+    Square(double side = 1)
+        :side{side}
+    {}
+
+    void draw() override
+    {
+        cout << "Square" << endl;
+    }
+    Drawing render() override
+    {
+        return { shade(side * side), 1 };
+    }
+
+    double getSide() const { return side; }
+    void setSide(double value)
+    {
+        side = value;
+        markDirty();
+    }
+
+protected:
+    Drawing redraw() override { return render(); }
+
+private:
+    double side;
+};
+
+// Composite class
+struct Group :GraphicObject
+{
+    std::string name;
+    Group(const std::string& name)
+        :name{name}
+    {}
+
+    void draw() override
+    {
+        cout << "Circle" << "Objects:" << endl;
+        for (auto&& o : objects)
+            o->draw();
+    }
+
+    Drawing render() override
+    {
+        Drawing drawing;
+        for (auto&& o : objects)
+            drawing += o->render();
+        return drawing;
+    }
+
+    // An object belongs to one group at a time: adding it moves it out of its old group, which is marked dirty too.
+    // A group cannot be added to itself or to one of its descendants.
+    void add(GraphicObject* object)
+    {
+        // On a cycle, draw(), render() and redraw() would recurse forever
+        for (GraphicObject* node = this; node; node = node->parent)
+        {
+            if (node == object)
+                throw invalid_argument("Group: an object cannot be added below itself");
+        }
+        if (object->parent)
+            static_cast<Group*>(object->parent)->remove(object);
+        object->parent = this;
+        objects.push_back(object);
+        markDirty();
+    }
+
+    void remove(GraphicObject* object)
+    {
+        auto found = std::find(objects.begin(), objects.end(), object);
+        if (found == objects.end())
+            return;
+        objects.erase(found);
+        object->parent = nullptr;
+        markDirty();
+    }
+
+    const std::vector<GraphicObject*>& children() const { return objects; }
+
+protected:
+    Drawing redraw() override
+    {
+        Drawing drawing;
+        for (auto&& o : objects)
+            drawing += o->drawIncremental();
+        return drawing;
+    }
+
+private:
+    std::vector<GraphicObject*> objects; // private, so every change goes through add() / remove()
+};
+
+// `leaves` circles and squares in groups of `fanout`, groups in groups of `fanout`, up to one root
+struct Scene
+{
+    deque<Circle> circles;
+    deque<Square> squares;
+    deque<Group> groups;
+
+    Group* build(size_t leaves, size_t fanout)
+    {
+        vector<GraphicObject*> level;
+        for (size_t i = 0; i < leaves; ++i)
+        {
+            if (i % 2)
+            {
+                circles.emplace_back(1.0 + i % 7);
+                level.push_back(&circles.back());
+            }
+            else
+            {
+                squares.emplace_back(1.0 + i % 5);
+                level.push_back(&squares.back());
+            }
+        }
+        while (level.size() > 1)
+        {
+            vector<GraphicObject*> parents;
+            for (size_t i = 0; i < level.size(); i += fanout)
+            {
+                groups.emplace_back("group " + to_string(groups.size()));
+                for (size_t j = i; j < min(i + fanout, level.size()); ++j)
+                    groups.back().add(level[j]);
+                parents.push_back(&groups.back());
+            }
+            level.swap(parents);
+        }
+        return &groups.back();
+    }
+};
+
+void benchmark(size_t leaves)
+{
+    using Clock = chrono::steady_clock;
+    Scene scene;
+    Group* root = scene.build(leaves, 8);
+    root->drawIncremental(); // first frame draws everything
+
+    mt19937 random(7);
+    const int frames = 10;
+    cout << "\n" << leaves << " leaves, " << frames << " frames, time per frame" << endl;
+
+    for (double changed : { 0.0001, 0.001, 0.01, 0.1 })
+    {
+        size_t edits = max<size_t>(1, static_cast<size_t>(leaves * changed));
+        chrono::duration<double> incremental(0), full(0);
+        bool same = true;
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (size_t e = 0; e < edits; ++e)
+            {
+                size_t i = random() % leaves;
+                if (i % 2)
+                {
+                    Circle& circle = scene.circles[i / 2];
+                    circle.setRadius(circle.getRadius() + 0.5);
+                }
+                else
+                {
+                    Square& square = scene.squares[i / 2];
+                    square.setSide(square.getSide() + 0.5);
+                }
+            }
+
+            auto start = Clock::now();
+            Drawing cached = root->drawIncremental();
+            incremental += Clock::now() - start;
+
+            start = Clock::now();
+            Drawing redrawn = root->render();
+            full += Clock::now() - start;
+
+            same = same && cached.primitives == redrawn.primitives && fabs(cached.ink - redrawn.ink) <= 1e-9 * redrawn.ink;
+        }
+        cout << "  " << changed * 100 << "% of leaves changed: drawIncremental() " << incremental.count() * 1000 / frames
+             << " ms, render() " << full.count() * 1000 / frames << " ms" << (same ? "" : "  (MISMATCH)") << endl;
+    }
+}
+
+int main()
+{
+    Group root("root");
+    Circle c1, c2;
+    root.add(&c1);
+
+    Group sub("sub");
+    sub.add(&c2);
+
+    root.add(&sub);
+
+    root.draw();
+    Drawing first = root.drawIncremental();
+
+    // Only c2, sub and root are redrawn; c1 comes from its cache
+    c2.setRadius(2);
+    cout << "c1 dirty: " << c1.isDirty() << ", sub dirty: " << sub.isDirty() << ", root dirty: " << root.isDirty() << endl;
+    Drawing second = root.drawIncremental();
+    cout << "Ink before: " << first.ink << ", after: " << second.ink << endl;
+
+    benchmark(1000000);
+
+    return 0;
+}
@@ -0,0 +1,542 @@
+/*
+Parallel traversal for the Group tree of Composite_1.cpp.
+
+Group::draw() walks the whole tree on one thread. ParallelTraversal splits it across a WorkStealingPool instead:
+
+- every group whose subtree is larger than the sequential cutoff becomes a task per child subtree; smaller subtrees are walked
+  recursively by the thread that reached them, since a task costs more than it saves there;
+- every thread keeps its own task deque and works on its newest task; a thread that runs out steals the oldest task of another,
+  which is usually a large subtree, so skewed trees spread out on their own;
+- a thread that waits for its children runs other tasks meanwhile, so nested waits never block a worker.
+
+forEach() visits the nodes in whatever order the threads reach them. When the order matters, map() returns one result per node in
+preorder (the order of the sequential walk), and draw(root, out, Order::Preorder) prints exactly what Group::draw() prints: every
+node knows its preorder index from the subtree sizes, so results land in place without sorting.
+
+Subtree sizes are cached in the groups and refreshed, on the calling thread, before each traversal; the tree must not change
+while one is running. If a callback throws, the traversal still runs to completion and then rethrows the first exception on the
+calling thread.
+
+Build: g++ -std=c++17 -O2 -pthread Composite_Parallel.cpp
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+struct Group;
+
+// Component interface
+struct GraphicObject
+{
+    virtual void draw(ostream& out) = 0;
+    void draw() { draw(cout); }
+
+    // Cost of drawing this object alone, in arbitrary units of work
+    virtual double shade() const = 0;
+
+    // Number of nodes in this subtree, itself included
+    virtual size_t subtreeSize() const = 0;
+
+    virtual Group* asGroup() { return nullptr; }
+};
+
+// Leaf class
+struct Circle : GraphicObject
+{
+    double radius;
+    Circle(double radius = 1)
+        :radius{radius}
+    {}
+
+    using GraphicObject::draw;
+    void draw(ostream& out) override
+    {
+        out << "Circle" << endl;
+    }
+    double shade() const override
+    {
+        double sum = 0;
+        for (int i = 1; i <= 200; ++i)
+            sum += sqrt(radius * i);
+        return sum;
+    }
+    size_t subtreeSize() const override { return 1; }
+};
+// Leaf class
+struct Square : GraphicObject
+{
+    double side;
+    Square(double side = 1)
+        :side{side}
+    {}
+
+    using GraphicObject::draw;
+    void draw(ostream& out) override
+    {
+        out << "Square" << endl;
+    }
+    double shade() const override
+    {
+        double sum = 0;
+        for (int i = 1; i <= 200; ++i)
+            sum += sqrt(side + i);
+        return sum;
+    }
+    size_t subtreeSize() const override { return 1; }
+};
+
+// Composite class
+struct Group :GraphicObject
+{
+    std::string name;
+    Group(const std::string& name)
+        :name{name}
+    {}
+
+    using GraphicObject::draw;
+    void draw(ostream& out) override
+    {
+        drawSelf(out);
+        for (auto&& o : objects)
+            o->draw(out);
+    }
+
+    // The line a group prints before its children
+    void drawSelf(ostream& out)
+    {
+        out << "Circle" << "Objects:" << endl;
+    }
+
+    double shade() const override { return 0; }
+
+    size_t subtreeSize() const override { return size; }
+
+    // Recomputes the cached subtree sizes of this group and every group below it
+    size_t updateSizes()
+    {
+        size = 1;
+        for (auto&& o : objects)
+        {
+            Group* group = o->asGroup();
+            size += group ? group->updateSizes() : 1;
+        }
+        return size;
+    }
+
+    Group* asGroup() override { return this; }
+
+    std::vector<GraphicObject*> objects;
+
+private:
+    size_t size = 1;
+};
+
+// Fixed set of threads, one task deque each; idle threads steal from the others
+class WorkStealingPool
+{
+public:
+    // Work shared by one wait(): counts its unfinished tasks and keeps the first exception one of them threw
+    struct TaskGroup
+    {
+        atomic<size_t> pending{ 0 };
+
+        void fail(exception_ptr thrown)
+        {
+            lock_guard<mutex> guard(errorLock);
+            if (!error)
+                error = thrown;
+        }
+
+    private:
+        friend class WorkStealingPool;
+        mutex errorLock;
+        exception_ptr error;
+    };
+
+    // `threads` includes the thread that calls wait(), so a pool of 1 runs everything on the caller
+    explicit WorkStealingPool(unsigned threads)
+        : queues(max(1u, threads))
+    {
+        for (unsigned i = 1; i < queues.size(); ++i)
+            workers.emplace_back([this, i] { workerLoop(i); });
+    }
+
+    ~WorkStealingPool()
+    {
+        stopping = true;
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    unsigned size() const { return static_cast<unsigned>(queues.size()); }
+
+    void spawn(TaskGroup& group, function<void()> work)
+    {
+        group.pending.fetch_add(1, memory_order_relaxed);
+        Queue& queue = queues[current()];
+        lock_guard<mutex> lock(queue.lock);
+        queue.tasks.push_back({ move(work), &group });
+    }
+
+    // Runs tasks (any tasks) until every task of `group` has finished, then rethrows the first exception of the group
+    void wait(TaskGroup& group)
+    {
+        unsigned self = current();
+        while (group.pending.load(memory_order_acquire) != 0)
+        {
+            if (!runOne(self))
+                this_thread::yield();
+        }
+        if (group.error)
+            rethrow_exception(group.error);
+    }
+
+private:
+    struct Task
+    {
+        function<void()> work;
+        TaskGroup* group;
+    };
+
+    struct alignas(64) Queue
+    {
+        mutex lock;
+        deque<Task> tasks;
+    };
+
+    // The pool and queue of the calling worker thread
+    struct Worker
+    {
+        const WorkStealingPool* pool = nullptr;
+        unsigned index = 0;
+    };
+
+    static Worker& currentWorker()
+    {
+        static thread_local Worker worker;
+        return worker;
+    }
+
+    // Index of the calling thread's queue in this pool; any thread outside it, workers of other pools included, uses queue 0
+    unsigned current() const
+    {
+        const Worker& worker = currentWorker();
+        return worker.pool == this ? worker.index : 0;
+    }
+
+    bool runOne(unsigned self)
+    {
+        Task task;
+        if (!popNewest(self, task) && !stealOldest(self, task))
+            return false;
+        try
+        {
+            task.work();
+        }
+        catch (...)
+        {
+            task.group->fail(current_exception());
+        }
+        task.group->pending.fetch_sub(1, memory_order_release);
+        return true;
+    }
+
+    bool popNewest(unsigned self, Task& task)
+    {
+        Queue& queue = queues[self];
+        lock_guard<mutex> lock(queue.lock);
+        if (queue.tasks.empty())
+            return false;
+        task = move(queue.tasks.back());
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    bool stealOldest(unsigned self, Task& task)
+    {
+        for (unsigned i = 1; i < queues.size(); ++i)
+        {
+            Queue& victim = queues[(self + i) % queues.size()];
+            lock_guard<mutex> lock(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                task = move(victim.tasks.front());
+                victim.tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned index)
+    {
+        currentWorker() = { this, index };
+        unsigned idle = 0;
+        while (!stopping)
+        {
+            if (runOne(index))
+                idle = 0;
+            else if (++idle < 64)
+                this_thread::yield();
+            else
+                this_thread::sleep_for(chrono::microseconds(50));
+        }
+    }
+
+    vector<Queue> queues;
+    vector<thread> workers;
+    atomic<bool> stopping{ false };
+};
+
+// Visits a Group tree on a WorkStealingPool
+class ParallelTraversal
+{
+public:
+    enum class Order { Any, Preorder };
+
+    ParallelTraversal(WorkStealingPool& pool, size_t cutoff = 2048)
+        : pool(pool), cutoff(cutoff)
+    {}
+
+    // Calls visit(node, preorderIndex) once for every node, on any thread, in any order
+    template <typename Visit>
+    void forEach(Group& root, Visit visit)
+    {
+        root.updateSizes();
+        traverse(root, visit);
+    }
+
+    // results[i] = map(node) for the node that is i-th in preorder
+    template <typename Result, typename Map>
+    vector<Result> map(Group& root, Map map)
+    {
+        vector<Result> results(root.updateSizes());
+        traverse(root, [&results, &map](GraphicObject* node, size_t index) { results[index] = map(node); });
+        return results;
+    }
+
+    // Group::draw() in parallel; Order::Preorder gives the same output as the sequential draw()
+    void draw(Group& root, ostream& out, Order order)
+    {
+        auto drawNode = [](GraphicObject* node, ostream& text)
+        {
+            if (Group* group = node->asGroup())
+                group->drawSelf(text);
+            else
+                node->draw(text);
+        };
+
+        if (order == Order::Preorder)
+        {
+            for (const string& text : map<string>(root, [&drawNode](GraphicObject* node)
+                {
+                    ostringstream text;
+                    drawNode(node, text);
+                    return text.str();
+                }))
+                out << text;
+            return;
+        }
+
+        mutex lock;
+        forEach(root, [&](GraphicObject* node, size_t)
+        {
+            ostringstream text;
+            drawNode(node, text);
+            lock_guard<mutex> guard(lock);
+            out << text.str();
+        });
+    }
+
+private:
+    // forEach() on a tree whose sizes are up to date
+    template <typename Visit>
+    void traverse(Group& root, Visit visit)
+    {
+        WorkStealingPool::TaskGroup all;
+        try
+        {
+            visitSubtree(&root, 0, visit, all);
+        }
+        catch (...)
+        {
+            all.fail(current_exception()); // the tasks spawned so far still refer to `all` and `visit`
+        }
+        pool.wait(all);
+    }
+
+    template <typename Visit>
+    void visitSubtree(GraphicObject* node, size_t index, Visit& visit, WorkStealingPool::TaskGroup& tasks)
+    {
+        Group* group = node->asGroup();
+        if (!group || group->subtreeSize() <= cutoff)
+        {
+            visitSequential(node, index, visit);
+            return;
+        }
+
+        visit(node, index);
+        size_t child = index + 1;
+        for (auto&& o : group->objects)
+        {
+            if (o->subtreeSize() <= cutoff)
+                visitSequential(o, child, visit);
+            else
+                pool.spawn(tasks, [this, o, child, &visit, &tasks] { visitSubtree(o, child, visit, tasks); });
+            child += o->subtreeSize();
+        }
+    }
+
+    template <typename Visit>
+    void visitSequential(GraphicObject* node, size_t index, Visit& visit)
+    {
+        visit(node, index);
+        if (Group* group = node->asGroup())
+        {
+            size_t child = index + 1;
+            for (auto&& o : group->objects)
+            {
+                visitSequential(o, child, visit);
+                child += o->subtreeSize();
+            }
+        }
+    }
+
+    WorkStealingPool& pool;
+    size_t cutoff;
+};
+
+// Owns the nodes of a generated tree
+struct Scene
+{
+    deque<Circle> circles;
+    deque<Square> squares;
+    deque<Group> groups;
+
+    GraphicObject* leaf(size_t i)
+    {
+        if (i % 2)
+        {
+            circles.emplace_back(1.0 + i % 7);
+            return &circles.back();
+        }
+        squares.emplace_back(1.0 + i % 5);
+        return &squares.back();
+    }
+
+    Group* group()
+    {
+        groups.emplace_back("group " + to_string(groups.size()));
+        return &groups.back();
+    }
+
+    // `leaves` leaves in groups of `fanout`, groups in groups of `fanout`, up to one root
+    Group* balanced(size_t leaves, size_t fanout)
+    {
+        vector<GraphicObject*> level;
+        for (size_t i = 0; i < leaves; ++i)
+            level.push_back(leaf(i));
+        while (level.size() > 1 || !level.front()->asGroup())
+        {
+            vector<GraphicObject*> parents;
+            for (size_t i = 0; i < level.size(); i += fanout)
+            {
+                Group* parent = group();
+                for (size_t j = i; j < min(i + fanout, level.size()); ++j)
+                    parent->objects.push_back(level[j]);
+                parents.push_back(parent);
+            }
+            level.swap(parents);
+        }
+        return level.front()->asGroup();
+    }
+
+    // Every group puts 90% of its leaves in one child and 10% in another: a long, lopsided spine
+    Group* skewed(size_t leaves)
+    {
+        Group* root = group();
+        if (leaves <= 64)
+        {
+            for (size_t i = 0; i < leaves; ++i)
+                root->objects.push_back(leaf(i));
+            return root;
+        }
+        root->objects.push_back(skewed(leaves / 10));
+        root->objects.push_back(skewed(leaves - leaves / 10));
+        return root;
+    }
+};
+
+void benchmark(const char* label, Group& root)
+{
+    using Clock = chrono::steady_clock;
+
+    auto start = Clock::now();
+    vector<double> expected(root.updateSizes());
+    size_t next = 0;
+    function<void(GraphicObject*)> walk = [&](GraphicObject* node)
+    {
+        expected[next++] = node->shade();
+        if (Group* group = node->asGroup())
+            for (auto&& o : group->objects)
+                walk(o);
+    };
+    walk(&root);
+    chrono::duration<double> sequential = Clock::now() - start;
+
+    cout << "\n" << label << ", " << expected.size() << " nodes: sequential " << sequential.count() * 1000 << " ms" << endl;
+
+    unsigned cores = max(1u, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    for (unsigned threads = 1; threads < cores; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+
+    for (unsigned threads : threadCounts)
+    {
+        WorkStealingPool pool(threads);
+        ParallelTraversal traversal(pool);
+        start = Clock::now();
+        vector<double> results = traversal.map<double>(root, [](GraphicObject* node) { return node->shade(); });
+        chrono::duration<double> parallel = Clock::now() - start;
+        cout << "  " << threads << " thread(s): " << parallel.count() * 1000 << " ms, speedup "
+             << sequential.count() / parallel.count() << (results == expected ? "" : "  (MISMATCH)") << endl;
+    }
+}
+
+int main()
+{
+    Group root("root");
+    Circle c1, c2;
+    root.objects.emplace_back(&c1);
+
+    Group sub("sub");
+    sub.objects.push_back(&c2);
+
+    root.objects.push_back(&sub);
+
+    WorkStealingPool pool(thread::hardware_concurrency());
+    ParallelTraversal traversal(pool, 0); // no cutoff, so even this tiny tree is split
+    traversal.draw(root, cout, ParallelTraversal::Order::Preorder);
+
+    Scene scene;
+    Group* balanced = scene.balanced(1000000, 8);
+    Group* skewed = scene.skewed(1000000);
+    benchmark("Balanced tree (fanout 8)", *balanced);
+    benchmark("Skewed tree (90/10 splits)", *skewed);
+
+    return 0;
+}